@@ -6,6 +6,10 @@
 #if !defined(SCATTERED_BENCHMARK_ACCESS_PATTERNS_HPP)
 #define SCATTERED_BENCHMARK_ACCESS_PATTERNS_HPP
 
+#include <random>
+#include <vector>
+#include <boost/mpl/vector.hpp>
+
 ////////////////////////////////////////////////////////////////////////////////
 
 struct sequential {
@@ -21,6 +25,30 @@ auto name(sequential) RETURNS(std::string{"sequential"});
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/// Runs the operation's kernel over whole columns
+/// (operation.columns(container)) if it provides one for the container, and
+/// visits every row in order otherwise.
+struct column_kernel {
+  template<class C, class F>
+  [[gnu::flatten, gnu::hot]] inline void operator()(C&& container, F&& operation) const {
+    visit(container, operation, 0);
+  }
+
+  template<class C, class F>
+  [[gnu::flatten, gnu::hot]] inline auto visit(C& container, F& operation, int) const
+      -> decltype(operation.columns(container), void()) {
+    operation.columns(container);
+  }
+  template<class C, class F>
+  [[gnu::flatten, gnu::hot]] inline void visit(C& container, F& operation, long) const {
+    sequential{}(container, operation);
+  }
+};
+
+auto name(column_kernel) RETURNS(std::string{"column_kernel"});
+
+////////////////////////////////////////////////////////////////////////////////
+
 template<std::size_t stride> struct strided {
   template<class C, class F>
   [[gnu::flatten, gnu::hot]] inline void operator()(C&& container, F&& operation) const {
@@ -35,7 +63,35 @@ auto name(strided<stride>) RETURNS("strided_" + std::to_string(stride));
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/// Visits size() rows at random positions (the same ones for every container of
+/// the same size).
+struct random_access {
+  template<class C, class F>
+  [[gnu::flatten, gnu::hot]] inline void operator()(C&& container, F&& operation) const {
+    for (auto i : indices(container.size())) {
+      operation(container[i]);
+    }
+  }
+
+  static const std::vector<std::size_t>& indices(std::size_t size) {
+    static std::vector<std::size_t> is;
+    if (is.size() != size) {
+      std::mt19937 rng(1);
+      std::uniform_int_distribution<std::size_t> dist(0, size - 1);
+      is.resize(size);
+      for (auto& i : is) { i = dist(rng); }
+    }
+    return is;
+  }
+};
+
+auto name(random_access) RETURNS(std::string{"random"});
+
+////////////////////////////////////////////////////////////////////////////////
+
 using access_patterns = boost::mpl::vector<sequential
+                                           , column_kernel
+                                           , random_access
                                            // , strided<2>
                                            // , strided<4>
                                            >;
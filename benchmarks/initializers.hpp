@@ -23,8 +23,9 @@ struct fill_with_random_values {
   template<class C>
   enable_if_scattered<C> operator()(C&& c) {
     for (auto&& i : c) {
-      boost::fusion::for_each(i, [&](auto& o) {
-          o.second = v;
+      using columns = typename scattered::detail::unqualified_t<decltype(i)>::columns;
+      scattered::detail::for_each_column(columns{}, [&](auto col) {
+          scattered::get<typename decltype(col)::key>(i) = v;
         });
     }
   }
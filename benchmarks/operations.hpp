@@ -6,10 +6,12 @@
 #if !defined(SCATTERED_BENCHMARK_OPERATIONS_HPP)
 #define SCATTERED_BENCHMARK_OPERATIONS_HPP
 
+#include <boost/mpl/vector.hpp>
 #include "types.hpp"
 #include "is_fusion_pair.hpp"
 #include "is_scattered.hpp"
 #include "scattered/detail/unqualified.hpp"
+#include "scattered/transform.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -26,9 +28,16 @@ struct multiply_by_itself_all {
   };
 
   template<class T>
-  [[gnu::always_inline]] inline void operator()(T&& o) const {
+  [[gnu::always_inline]] inline disable_if_scattered<T> operator()(T&& o) const {
     boost::fusion::for_each(o, impl{});
   }
+  template<class T>
+  [[gnu::always_inline]] inline enable_if_scattered<T> operator()(T&& o) const {
+    using columns = typename scattered::detail::unqualified_t<T>::columns;
+    scattered::detail::for_each_column(columns{}, [&](auto c) {
+        impl{}(scattered::get<typename decltype(c)::key>(o));
+      });
+  }
 };
 
 auto name(multiply_by_itself_all) RETURNS(std::string{"multiply_by_itself_all"});
@@ -42,6 +51,11 @@ struct multiply_by_itself_one {
   [[gnu::always_inline]] inline enable_if_scattered<T> operator()(T&& o) const {
     scattered::get<k::d0>(o) *= scattered::get<k::d0>(o);
   }
+  /// Squares the whole d0 column with a vectorized kernel
+  template<class T, class S>
+  void columns(scattered::vector<T, S>& v) const {
+    scattered::transform<k::d0>(v, [](auto d0) { return d0 * d0; }, k::d0{});
+  }
 };
 
 auto name(multiply_by_itself_one) RETURNS(std::string{"multiply_by_itself_one"});
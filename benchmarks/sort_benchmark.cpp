@@ -0,0 +1,73 @@
+// (C) Copyright Gonzalo Brito Gadeschi 2014
+// Use, modification and distribution are subject to the Boost Software License,
+// Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt).
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "scattered/vector.hpp"
+#include "scattered/sort.hpp"
+#include "time_function.hpp"
+#include "types.hpp"
+
+/// Sorts by the member d0: std::stable_sort of the rows of a std::vector<T>
+/// vs the sequential, the radix and the parallel sort_by of a
+/// scattered::vector<T>
+template <class T> struct run_benchmark {
+  void operator()(const std::size_t size) const {
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> dist;
+    std::vector<T> data(size);
+    for (auto&& i : data) {
+      boost::fusion::for_each(i, [&](auto& o) { o = dist(rng); });
+    }
+    auto report = [&](std::string what, long time) {
+      std::cout << std::setw(50) << name(T{}) + "_" + what << std::setw(20)
+                << size << std::setw(20) << time << "\n";
+    };
+
+    auto std_vec = data;
+    report("std_vector_stable_sort", time_fn([&]() {
+             std::stable_sort(std_vec.begin(), std_vec.end(),
+                              [](auto a, auto b) { return a.d0 < b.d0; });
+           }));
+
+    auto fill = [&](scattered::vector<T>& v) {
+      v.clear();
+      for (auto&& i : data) { v.push_back(i); }
+    };
+    scattered::vector<T> vec;
+    fill(vec);
+    report("scattered_vector_sort_by",
+           time_fn([&]() { scattered::sort_by<k::d0>(vec); }));
+
+    fill(vec);
+    report("scattered_vector_radix_sort_by",
+           time_fn([&]() { scattered::radix_sort_by<k::d0>(vec); }));
+
+    const std::size_t max_threads = std::thread::hardware_concurrency();
+    for (std::size_t no_threads = 1; no_threads <= max_threads;
+         no_threads *= 2) {
+      fill(vec);
+      report("scattered_vector_parallel_sort_by_"
+                 + std::to_string(no_threads),
+             time_fn([&]() {
+               scattered::parallel_sort_by<k::d0>(vec, std::less<>{},
+                                                  no_threads);
+             }));
+    }
+  }
+};
+
+int main() {
+  for (std::size_t size : {std::size_t(1e6), std::size_t(1e7)}) {
+    run_benchmark<very_small_object>{}(size);
+    run_benchmark<small_object>{}(size);
+  }
+  return 0;
+}
@@ -7,6 +7,7 @@
 #define SCATTERED_BENCHMARK_TYPES_HPP
 
 #include <boost/fusion/adapted/struct/adapt_assoc_struct.hpp>
+#include <boost/mpl/vector.hpp>
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -7,6 +7,7 @@
 #include <iostream>
 #include <fstream>
 #include "scattered/vector.hpp"
+#include "scattered/tiled_vector.hpp"
 #include "benchmark.hpp"
 #include "operations.hpp"
 #include "access_patterns.hpp"
@@ -18,6 +19,29 @@ template<class T> using std_vector       = std::vector<T>;
 template<class T> auto name(std_vector<T>) RETURNS("std_vector");
 template<class T> using scattered_vector = scattered::vector<T>;
 template<class T> auto name(scattered_vector<T>) RETURNS("scattered_vector");
+template<class T>
+using scattered_arena_vector = scattered::vector<T, scattered::arena_storage<>>;
+template<class T>
+auto name(scattered_arena_vector<T>) RETURNS("scattered_arena_vector");
+template<class T> using scattered_tiled_vector = scattered::tiled_vector<T>;
+template<class T>
+auto name(scattered_tiled_vector<T>) RETURNS("scattered_tiled_vector");
+// Huge pages: compare the dTLB misses with `perf stat -e dTLB-load-misses`
+template<class T>
+using std_huge_page_vector = std::vector<T, scattered::huge_page_allocator<T>>;
+template<class T>
+auto name(std_huge_page_vector<T>) RETURNS("std_huge_page_vector");
+template<class T>
+using scattered_huge_page_vector
+    = scattered::vector<T, scattered::huge_page_storage<>>;
+template<class T>
+auto name(scattered_huge_page_vector<T>) RETURNS("scattered_huge_page_vector");
+template<class T>
+using scattered_prefaulted_huge_page_vector = scattered::vector
+    <T, scattered::huge_page_storage<scattered::huge_pages::madvise, true>>;
+template<class T>
+auto name(scattered_prefaulted_huge_page_vector<T>)
+    RETURNS("scattered_prefaulted_huge_page_vector");
 
 template<template <class> class Container> struct run_benchmark {
   template <typename Seq> void operator()(Seq) {
@@ -57,6 +81,9 @@ template<template <class> class Container> struct run_benchmark {
 };
 
 int main() {
+  // Column kernels: select with SCATTERED_ISA=generic|sse4.2|avx2|avx512
+  std::cout << "# isa: " << name(scattered::selected_isa()) << "\n";
+
   boost::mpl::cartesian_product<boost::mpl::vector<
                                   operations,
                                   access_patterns,
@@ -68,5 +95,36 @@ int main() {
                                   access_patterns,
                                   test_types
                                   >>(run_benchmark<scattered_vector>());
+
+  boost::mpl::cartesian_product<boost::mpl::vector<
+                                  operations,
+                                  access_patterns,
+                                  test_types
+                                  >>(run_benchmark<scattered_arena_vector>());
+
+  boost::mpl::cartesian_product<boost::mpl::vector<
+                                  operations,
+                                  access_patterns,
+                                  test_types
+                                  >>(run_benchmark<scattered_tiled_vector>());
+
+  boost::mpl::cartesian_product<boost::mpl::vector<
+                                  operations,
+                                  access_patterns,
+                                  test_types
+                                  >>(run_benchmark<std_huge_page_vector>());
+
+  boost::mpl::cartesian_product<boost::mpl::vector<
+                                  operations,
+                                  access_patterns,
+                                  test_types
+                                  >>(run_benchmark<scattered_huge_page_vector>());
+
+  boost::mpl::cartesian_product<boost::mpl::vector<
+                                  operations,
+                                  access_patterns,
+                                  test_types
+                                  >>(run_benchmark
+                                     <scattered_prefaulted_huge_page_vector>());
   return 0;
 }
@@ -0,0 +1,92 @@
+// (C) Copyright Gonzalo Brito Gadeschi 2014
+// Use, modification and distribution are subject to the Boost Software License,
+// Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt).
+
+/// \file \brief Allocator with over-aligned and padded allocations
+
+#if !defined(SCATTERED_DETAIL_ALIGNED_ALLOCATOR_HPP)
+#define SCATTERED_DETAIL_ALIGNED_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+namespace scattered {
+
+/// \brief Allocator whose allocations are aligned to Alignment bytes and
+/// padded to a multiple of Width elements
+///
+/// allocate(n) returns storage for round_up(n, Width) elements, so that a
+/// SIMD kernel processing Width elements at a time can access the elements
+/// [size, round_up(size, Width)) past the end of a container instead of
+/// running a scalar remainder loop. The values of those elements are
+/// unspecified.
+template <class T, std::size_t Alignment = 64, std::size_t Width = 1>
+struct aligned_allocator {
+  static_assert(Alignment != 0 && (Alignment & (Alignment - 1)) == 0,
+                "the alignment must be a power of two");
+  static_assert(Alignment >= alignof(T),
+                "the alignment must be at least the alignment of T");
+  static_assert(Width != 0, "the width must be at least one element");
+
+  using value_type = T;
+  using pointer = T*;
+  using const_pointer = T const*;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using propagate_on_container_move_assignment = std::true_type;
+  using is_always_equal = std::true_type;
+  template <class U> struct rebind {
+    using other = aligned_allocator<U, Alignment, Width>;
+  };
+
+  /// Alignment in bytes of the allocations
+  static const constexpr std::size_t alignment = Alignment;
+  /// Allocations are padded to a multiple of width elements
+  static const constexpr std::size_t width = Width;
+
+  aligned_allocator() noexcept = default;
+  template <class U>
+  aligned_allocator(const aligned_allocator<U, Alignment, Width>&) noexcept {}
+
+  /// \brief Number of elements allocated for a request of n elements
+  static constexpr size_type padded_size(const size_type n) noexcept {
+    return (n + Width - 1) / Width * Width;
+  }
+
+  T* allocate(const size_type n) {
+    if (n > max_size()) { throw std::bad_alloc(); }
+    // The original pointer is stored right before the aligned block:
+    const auto bytes = padded_size(n) * sizeof(T) + Alignment + sizeof(void*);
+    void* const raw = ::operator new(bytes);
+    const auto first = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*);
+    void* const aligned = reinterpret_cast<void*>(
+        (first + Alignment - 1) & ~static_cast<std::uintptr_t>(Alignment - 1));
+    static_cast<void**>(aligned)[-1] = raw;
+    return static_cast<T*>(aligned);
+  }
+  void deallocate(T* p, const size_type) noexcept {
+    if (p) { ::operator delete(reinterpret_cast<void**>(p)[-1]); }
+  }
+
+  size_type max_size() const noexcept {
+    return (std::numeric_limits<size_type>::max() - Alignment - sizeof(void*))
+           / sizeof(T) / Width * Width;
+  }
+
+  friend bool operator==(const aligned_allocator&,
+                         const aligned_allocator&) noexcept {
+    return true;
+  }
+  friend bool operator!=(const aligned_allocator&,
+                         const aligned_allocator&) noexcept {
+    return false;
+  }
+};
+
+}  // namespace scattered
+
+#endif  // SCATTERED_DETAIL_ALIGNED_ALLOCATOR_HPP
@@ -0,0 +1,465 @@
+// (C) Copyright Gonzalo Brito Gadeschi 2014
+// Use, modification and distribution are subject to the Boost Software License,
+// Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt).
+
+/// \file \brief Vector of bools packed in 64-bit words
+
+#if !defined(SCATTERED_DETAIL_BIT_VECTOR_HPP)
+#define SCATTERED_DETAIL_BIT_VECTOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <boost/container/vector.hpp>
+#include "assert.hpp"
+
+namespace scattered {
+
+namespace detail {
+
+using bit_word = std::uint64_t;
+static const constexpr std::size_t bits_per_word = 64;
+
+/// \brief Number of words needed to store n bits
+[[gnu::always_inline, gnu::const]] inline
+constexpr std::size_t no_words(const std::size_t n) noexcept {
+  return (n + bits_per_word - 1) / bits_per_word;
+}
+
+/// \brief Word with the bit i (mod bits_per_word) set
+[[gnu::always_inline, gnu::const]] inline
+constexpr bit_word bit_mask(const std::size_t i) noexcept {
+  return bit_word(1) << (i % bits_per_word);
+}
+
+/// \brief Reference proxy to a bit of a bit_vector
+class bit_reference {
+ public:
+  [[gnu::always_inline, gnu::hot]] inline
+  bit_reference(bit_word* w, const bit_word m) noexcept : w_(w), m_(m) {}
+  bit_reference(const bit_reference&) = default;
+
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  operator bool() const noexcept { return (*w_ & m_) != 0; }
+
+  [[gnu::always_inline, gnu::hot]] inline
+  const bit_reference& operator=(const bool value) const noexcept {
+    *w_ = value ? *w_ | m_ : *w_ & ~m_;
+    return *this;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  const bit_reference& operator=(const bit_reference& other) const noexcept {
+    return *this = static_cast<bool>(other);
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  void flip() const noexcept { *w_ ^= m_; }
+
+  inline friend void swap(bit_reference a, bit_reference b) noexcept {
+    const bool tmp = a;
+    a = static_cast<bool>(b);
+    b = tmp;
+  }
+
+ private:
+  bit_word* w_;  ///< Word containing the bit
+  bit_word m_;   ///< Mask of the bit in the word
+};
+
+/// \brief RandomAccessIterator over the bits of a bit_vector
+///
+/// The reference type is a bit_reference proxy (bool if is_const).
+template <bool is_const_> class bit_iterator {
+ public:
+  static const constexpr bool is_const = is_const_;
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = bool;
+  using difference_type = std::ptrdiff_t;
+  using reference = std::conditional_t<is_const, bool, bit_reference>;
+  using pointer = void;
+  using word_pointer
+      = std::conditional_t<is_const, const bit_word*, bit_word*>;
+  using This = bit_iterator<is_const>;
+
+  [[gnu::always_inline, gnu::hot]] inline bit_iterator() = default;
+  [[gnu::always_inline, gnu::hot]] inline
+  bit_iterator(word_pointer words, const difference_type i) noexcept
+      : w_(words),
+        i_(i) {}
+  /// \brief iterator -> const_iterator
+  template <bool c, std::enable_if_t<!c && is_const_, int> = 0>
+  [[gnu::always_inline, gnu::hot]] inline
+  bit_iterator(const bit_iterator<c>& other) noexcept : w_(other.words()),
+                                                        i_(other.index()) {}
+
+  /// \name Access operators
+  ///@{
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  reference operator*() const noexcept { return (*this)[0]; }
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  reference operator[](const difference_type n) const noexcept {
+    return make_reference(w_ + (i_ + n) / bits_per_word, bit_mask(i_ + n));
+  }
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  word_pointer words() const noexcept { return w_; }
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  difference_type index() const noexcept { return i_; }
+  ///@}
+
+  /// \name Traversal operators (++, +=, +, --, -=, -)
+  ///@{
+  [[gnu::always_inline, gnu::hot]] inline This& operator++() noexcept {
+    ++i_;
+    return *this;
+  }
+  [[gnu::always_inline, gnu::hot]] inline This operator++(int) noexcept {
+    const auto it = *this;
+    ++i_;
+    return it;
+  }
+  [[gnu::always_inline, gnu::hot]] inline This& operator--() noexcept {
+    --i_;
+    return *this;
+  }
+  [[gnu::always_inline, gnu::hot]] inline This operator--(int) noexcept {
+    const auto it = *this;
+    --i_;
+    return it;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  This& operator+=(const difference_type n) noexcept {
+    i_ += n;
+    return *this;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  This& operator-=(const difference_type n) noexcept {
+    i_ -= n;
+    return *this;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  friend This operator+(This a, const difference_type n) noexcept {
+    return a += n;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  friend This operator+(const difference_type n, This a) noexcept {
+    return a += n;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  friend This operator-(This a, const difference_type n) noexcept {
+    return a -= n;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  friend difference_type operator-(const This& l, const This& r) noexcept {
+    return l.i_ - r.i_;
+  }
+  ///@}
+
+  /// \name Comparison operators (==, !=, <, >, <=, >=)
+  ///@{
+  [[gnu::always_inline, gnu::hot]] inline
+  friend bool operator==(const This& l, const This& r) noexcept {
+    return l.i_ == r.i_;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  friend bool operator!=(const This& l, const This& r) noexcept {
+    return l.i_ != r.i_;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  friend bool operator<(const This& l, const This& r) noexcept {
+    return l.i_ < r.i_;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  friend bool operator>(const This& l, const This& r) noexcept {
+    return l.i_ > r.i_;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  friend bool operator<=(const This& l, const This& r) noexcept {
+    return l.i_ <= r.i_;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  friend bool operator>=(const This& l, const This& r) noexcept {
+    return l.i_ >= r.i_;
+  }
+  ///@}
+
+ private:
+  word_pointer w_ = nullptr;  ///< First word of the bit_vector
+  difference_type i_ = 0;     ///< Bit index
+
+  [[gnu::always_inline, gnu::hot, gnu::pure]] static inline
+  bool make_reference(const bit_word* w, const bit_word m) noexcept {
+    return (*w & m) != 0;
+  }
+  [[gnu::always_inline, gnu::hot, gnu::pure]] static inline
+  bit_reference make_reference(bit_word* w, const bit_word m) noexcept {
+    return {w, m};
+  }
+};
+
+}  // namespace detail
+
+/// \brief Sequence of bools packed in 64-bit words
+///
+/// It is the container of the bool columns of scattered::vector, and the
+/// bitmask type of the predicate API (see mask.hpp). Like std::vector<bool>,
+/// its references are proxies. The bits past size() of the last word are
+/// always zero, so that count(), any(), all() and the bitwise operators work
+/// a word at a time.
+template <class Allocator = std::allocator<std::uint64_t>> class bit_vector {
+ public:
+  using word_type = detail::bit_word;
+  using words_type = boost::container::vector<word_type, Allocator>;
+  using allocator_type = Allocator;
+  using value_type = bool;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = detail::bit_reference;
+  using const_reference = bool;
+  using iterator = detail::bit_iterator<false>;
+  using const_iterator = detail::bit_iterator<true>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+  static const constexpr std::size_t word_bits = detail::bits_per_word;
+
+  /// \name Constructors
+  ///@{
+  bit_vector() = default;
+  explicit bit_vector(const size_type n, const bool value = false) {
+    resize(n, value);
+  }
+  bit_vector(const bit_vector&) = default;
+  bit_vector(bit_vector&& other) noexcept : words_(std::move(other.words_)),
+                                            size_(other.size_) {
+    other.size_ = 0;
+  }
+  bit_vector& operator=(const bit_vector&) = default;
+  bit_vector& operator=(bit_vector&& other) noexcept {
+    words_ = std::move(other.words_);
+    size_ = other.size_;
+    other.size_ = 0;
+    return *this;
+  }
+  ///@}
+
+  /// \name Iterators
+  ///@{
+  iterator begin() noexcept { return {words(), 0}; }
+  iterator end() noexcept { return {words(), difference_type(size_)}; }
+  const_iterator begin() const noexcept { return cbegin(); }
+  const_iterator end() const noexcept { return cend(); }
+  const_iterator cbegin() const noexcept { return {words(), 0}; }
+  const_iterator cend() const noexcept {
+    return {words(), difference_type(size_)};
+  }
+  reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+  reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+  const_reverse_iterator rbegin() const noexcept {
+    return const_reverse_iterator(end());
+  }
+  const_reverse_iterator rend() const noexcept {
+    return const_reverse_iterator(begin());
+  }
+  ///@}
+
+  /// \name Element access
+  ///@{
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  reference operator[](const size_type i) noexcept {
+    return {words() + i / word_bits, detail::bit_mask(i)};
+  }
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  const_reference operator[](const size_type i) const noexcept {
+    return (words()[i / word_bits] & detail::bit_mask(i)) != 0;
+  }
+  reference front() noexcept { return (*this)[0]; }
+  const_reference front() const noexcept { return (*this)[0]; }
+  reference back() noexcept { return (*this)[size_ - 1]; }
+  const_reference back() const noexcept { return (*this)[size_ - 1]; }
+  /// \brief Packed words: the bit i is the bit i % 64 of the word i / 64
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  word_type* words() noexcept { return words_.data(); }
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  word_type const* words() const noexcept { return words_.data(); }
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  size_type no_words() const noexcept { return words_.size(); }
+  ///@}
+
+  /// \name Capacity
+  ///@{
+  bool empty() const noexcept { return size_ == 0; }
+  size_type size() const noexcept { return size_; }
+  size_type capacity() const noexcept { return words_.capacity() * word_bits; }
+  size_type max_size() const noexcept { return words_.max_size() * word_bits; }
+  void reserve(const size_type n) { words_.reserve(detail::no_words(n)); }
+  void shrink_to_fit() { words_.shrink_to_fit(); }
+  ///@}
+
+  /// \name Modifiers
+  ///@{
+  void clear() noexcept {
+    words_.clear();
+    size_ = 0;
+  }
+  void resize(const size_type n, const bool value = false) {
+    if (n > size_) {
+      words_.resize(detail::no_words(n), word_type(0));
+      if (value) { fill(size_, n, true); }
+    } else {
+      words_.resize(detail::no_words(n));
+    }
+    size_ = n;
+    clear_tail();
+  }
+  void push_back(const bool value) {
+    if (size_ % word_bits == 0) { words_.push_back(word_type(0)); }
+    ++size_;
+    back() = value;
+  }
+  void emplace_back(const bool value) { push_back(value); }
+  void pop_back() noexcept {
+    back() = false;
+    --size_;
+    if (size_ % word_bits == 0) { words_.pop_back(); }
+  }
+  /// \brief Inserts n bits with value before pos
+  iterator insert(const_iterator pos, const size_type n, const bool value) {
+    const size_type first = pos.index();
+    const size_type old_size = size_;
+    resize(size_ + n);
+    for (size_type i = old_size; i != first; --i) {
+      (*this)[i - 1 + n] = (*this)[i - 1];
+    }
+    fill(first, first + n, value);
+    return begin() + first;
+  }
+  /// \brief Erases the bits [first, last)
+  iterator erase(const_iterator first, const_iterator last) {
+    const size_type f = first.index();
+    const size_type n = last - first;
+    for (size_type i = f + n; i < size_; ++i) { (*this)[i - n] = (*this)[i]; }
+    resize(size_ - n);
+    return begin() + f;
+  }
+  iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+  /// \brief Flips all the bits
+  void flip() noexcept {
+    for (auto& w : words_) { w = ~w; }
+    clear_tail();
+  }
+  inline friend void swap(bit_vector& a, bit_vector& b) noexcept {
+    std::swap(a.words_, b.words_);
+    std::swap(a.size_, b.size_);
+  }
+  ///@}
+
+  /// \name Word-at-a-time queries
+  ///@{
+  /// \brief Number of bits set
+  size_type count() const noexcept {
+    size_type result = 0;
+    for (auto w : words_) { result += __builtin_popcountll(w); }
+    return result;
+  }
+  /// \brief Is any bit set?
+  bool any() const noexcept {
+    for (auto w : words_) {
+      if (w != 0) { return true; }
+    }
+    return false;
+  }
+  bool none() const noexcept { return !any(); }
+  /// \brief Are all the bits set? (true if empty)
+  bool all() const noexcept {
+    const size_type full = size_ / word_bits;
+    for (size_type i = 0; i != full; ++i) {
+      if (words_[i] != ~word_type(0)) { return false; }
+    }
+    return size_ % word_bits == 0
+           || words_[full] == detail::bit_mask(size_) - 1;
+  }
+  /// \brief Calls f(i) for the index i of each bit set, in increasing order
+  template <class F> void for_each_set(F&& f) const {
+    for (size_type i = 0, e = words_.size(); i != e; ++i) {
+      for (word_type w = words_[i]; w != 0; w &= w - 1) {
+        f(i * word_bits + __builtin_ctzll(w));
+      }
+    }
+  }
+  ///@}
+
+  /// \name Bitwise operators (both operands must have the same size)
+  ///@{
+  bit_vector& operator&=(const bit_vector& o) noexcept {
+    ASSERT(size_ == o.size_, "the bit vectors must have the same size");
+    for (size_type i = 0, e = words_.size(); i != e; ++i) {
+      words_[i] &= o.words_[i];
+    }
+    return *this;
+  }
+  bit_vector& operator|=(const bit_vector& o) noexcept {
+    ASSERT(size_ == o.size_, "the bit vectors must have the same size");
+    for (size_type i = 0, e = words_.size(); i != e; ++i) {
+      words_[i] |= o.words_[i];
+    }
+    return *this;
+  }
+  bit_vector& operator^=(const bit_vector& o) noexcept {
+    ASSERT(size_ == o.size_, "the bit vectors must have the same size");
+    for (size_type i = 0, e = words_.size(); i != e; ++i) {
+      words_[i] ^= o.words_[i];
+    }
+    return *this;
+  }
+  friend bit_vector operator&(bit_vector a, const bit_vector& b) noexcept {
+    return a &= b;
+  }
+  friend bit_vector operator|(bit_vector a, const bit_vector& b) noexcept {
+    return a |= b;
+  }
+  friend bit_vector operator^(bit_vector a, const bit_vector& b) noexcept {
+    return a ^= b;
+  }
+  friend bit_vector operator~(bit_vector a) noexcept {
+    a.flip();
+    return a;
+  }
+  ///@}
+
+  /// \name Comparison operators (==, !=)
+  ///@{
+  friend bool operator==(const bit_vector& a, const bit_vector& b) noexcept {
+    return a.size_ == b.size_ && a.words_ == b.words_;
+  }
+  friend bool operator!=(const bit_vector& a, const bit_vector& b) noexcept {
+    return !(a == b);
+  }
+  ///@}
+
+ private:
+  words_type words_;
+  size_type size_ = 0;
+
+  /// \brief Sets the bits [first, last) to value
+  void fill(size_type first, const size_type last, const bool value) noexcept {
+    for (; first != last && first % word_bits != 0; ++first) {
+      (*this)[first] = value;
+    }
+    for (; last - first >= word_bits; first += word_bits) {
+      words_[first / word_bits] = value ? ~word_type(0) : word_type(0);
+    }
+    for (; first != last; ++first) { (*this)[first] = value; }
+  }
+  /// \brief Clears the bits past size() of the last word
+  void clear_tail() noexcept {
+    if (size_ % word_bits != 0) {
+      words_.back() &= detail::bit_mask(size_) - 1;
+    }
+  }
+};
+
+}  // namespace scattered
+
+#endif  // SCATTERED_DETAIL_BIT_VECTOR_HPP
@@ -0,0 +1,579 @@
+// (C) Copyright Gonzalo Brito Gadeschi 2014
+// Use, modification and distribution are subject to the Boost Software License,
+// Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt).
+
+/// \file \brief Storage with all columns in a single allocation
+
+#if !defined(SCATTERED_DETAIL_COLUMN_ARENA_HPP)
+#define SCATTERED_DETAIL_COLUMN_ARENA_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "assert.hpp"
+#include "columns.hpp"
+
+namespace scattered {
+
+namespace detail {
+
+/// \brief Non-owning view of a column: [data, data + size)
+template <class V> struct column_view {
+  using value_type = std::remove_const_t<V>;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = V&;
+  using const_reference = V const&;
+  using pointer = V*;
+  using const_pointer = V const*;
+  using iterator = V*;
+  using const_iterator = V const*;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  iterator begin() const noexcept { return data_; }
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  iterator end() const noexcept { return data_ + size_; }
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  const_iterator cbegin() const noexcept { return data_; }
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  const_iterator cend() const noexcept { return data_ + size_; }
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  pointer data() const noexcept { return data_; }
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  size_type size() const noexcept { return size_; }
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  bool empty() const noexcept { return size_ == 0; }
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  reference operator[](const size_type i) const noexcept { return data_[i]; }
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  reference front() const noexcept { return data_[0]; }
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  reference back() const noexcept { return data_[size_ - 1]; }
+
+  pointer data_;
+  size_type size_;
+};
+
+/// \brief Layout of a column_arena: the columns of a buffer of n rows are
+/// stored one after the other
+///
+/// Column i starts at offsets(n)[i] bytes and is aligned to the alignment of
+/// its value type.
+///
+/// A Layout of a column_arena provides:
+///  - iterator<V>, column_type<V>: iterator and view types of a column of V,
+///  - capacity(n): number of rows of a buffer that can hold n rows,
+///  - offsets(n): offset in bytes of the first element of each column,
+///  - bytes(n): size in bytes of a buffer of n rows,
+///  - max_size(b): maximum number of rows of a buffer of b bytes,
+///  - make_iterator<V>(p): iterator to the first element of a column at p.
+template <class Columns> struct contiguous_layout;
+
+template <class... Cs> struct contiguous_layout<column_list<Cs...>> {
+  using size_type = std::size_t;
+  template <class V> using iterator = V*;
+  template <class V> using column_type = column_view<V>;
+  static const constexpr std::size_t no_columns = sizeof...(Cs);
+
+  static constexpr size_type capacity(const size_type n) noexcept {
+    return n;
+  }
+
+  /// \brief Offset in bytes of the column c in a buffer of n rows (c ==
+  /// no_columns is the end of the last column)
+  static constexpr size_type offset(const size_type c, const size_type n) {
+    constexpr size_type sizes[] = {sizeof(typename Cs::value_type)...};
+    constexpr size_type alignments[] = {alignof(typename Cs::value_type)...};
+    size_type result = 0;
+    for (size_type i = 0; i != c; ++i) {
+      result = (result + alignments[i] - 1) / alignments[i] * alignments[i];
+      result += n * sizes[i];
+    }
+    return c == no_columns
+               ? result
+               : (result + alignments[c] - 1) / alignments[c] * alignments[c];
+  }
+
+  static std::array<size_type, no_columns> offsets(const size_type n) {
+    std::array<size_type, no_columns> result;
+    for (size_type i = 0; i != no_columns; ++i) { result[i] = offset(i, n); }
+    return result;
+  }
+
+  static constexpr size_type bytes(const size_type n) {
+    return offset(no_columns, n);
+  }
+
+  static size_type max_size(const size_type max_bytes) noexcept {
+    constexpr size_type sizes[] = {sizeof(typename Cs::value_type)...};
+    size_type row_bytes = 0;
+    for (auto s : sizes) { row_bytes += s; }
+    return max_bytes / row_bytes;
+  }
+
+  template <class V> static V* make_iterator(char* p) noexcept {
+    return reinterpret_cast<V*>(p);
+  }
+};
+
+/// \brief Buffer of Blocks blocks stored inside a column_arena
+template <class Block, std::size_t Blocks> struct inline_blocks {
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  Block* inline_data() noexcept { return blocks_; }
+  Block blocks_[Blocks];
+};
+template <class Block> struct inline_blocks<Block, 0> {
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  Block* inline_data() noexcept { return nullptr; }
+};
+
+/// \brief Block of a column_arena buffer
+using arena_block = std::max_align_t;
+
+/// \brief Number of blocks of a buffer of n rows of the Layout
+template <class Layout>
+constexpr std::size_t arena_blocks(const std::size_t n) noexcept {
+  return (Layout::bytes(n) + sizeof(arena_block) - 1) / sizeof(arena_block);
+}
+
+/// \brief Calls f(C{}) on each column of the list. If it throws on a column,
+/// calls undo(C{}) on the columns already processed and rethrows.
+///
+/// f must leave the column it throws on unchanged.
+template <class F, class Undo, class... Cs>
+void for_each_column_or_undo(column_list<Cs...> l, F&& f, Undo&& undo) {
+  std::size_t done = 0;
+  try {
+    for_each_column(l, [&](auto c) {
+      f(c);
+      ++done;
+    });
+  } catch (...) {
+    for_each_column(l, [&](auto c) {
+      using K = typename decltype(c)::key;
+      if (column_index<K, column_list<Cs...>>::value < done) { undo(c); }
+    });
+    throw;
+  }
+}
+
+/// \brief Destroys the n elements starting at first
+template <class It>
+void destroy_n(It first, const std::size_t n) noexcept {
+  using V = typename std::iterator_traits<It>::value_type;
+  if (!std::is_trivially_destructible<V>::value) {
+    for (std::size_t i = 0; i != n; ++i) { first[i].~V(); }
+  }
+}
+
+/// \brief Stores all columns in a single allocation
+///
+/// The buffer holds capacity() rows of every column, placed as specified by
+/// the Layout (e.g. contiguous_layout). All columns share one size and one
+/// capacity, and growing the arena is a single reallocation.
+///
+/// The first Layout::capacity(InlineCapacity) rows are stored inside the
+/// arena object, and the arena only allocates when it grows past them.
+template <class Columns, class Layout, class Allocator,
+          std::size_t InlineCapacity = 0>
+class column_arena;
+
+template <class... Cs, class Layout, class Allocator,
+          std::size_t InlineCapacity>
+class column_arena<column_list<Cs...>, Layout, Allocator, InlineCapacity>
+    : private inline_blocks
+      <arena_block,
+       InlineCapacity == 0
+           ? 0
+           : arena_blocks<Layout>(Layout::capacity(InlineCapacity))> {
+ public:
+  using columns = column_list<Cs...>;
+  using layout_type = Layout;
+  using size_type = std::size_t;
+  template <class U>
+  using column_type = typename Layout::template column_type<U>;
+  /// Number of rows stored inside the arena object
+  static const constexpr std::size_t inline_capacity
+      = InlineCapacity == 0 ? 0 : Layout::capacity(InlineCapacity);
+  /// Moving and swapping arenas only throws if the rows are inline and
+  /// moving an element throws
+  static const constexpr bool nothrow_move
+      = inline_capacity == 0
+        || nothrow_move_constructible_columns<column_list<Cs...>>::value;
+
+ private:
+  static const constexpr std::size_t no_columns = sizeof...(Cs);
+  using block_type = arena_block;
+  using inline_base = inline_blocks
+      <block_type,
+       inline_capacity == 0 ? 0 : arena_blocks<Layout>(inline_capacity)>;
+  using allocator_type = typename std::allocator_traits
+      <Allocator>::template rebind_alloc<block_type>;
+  using allocator_traits = std::allocator_traits<allocator_type>;
+  template <class V>
+  using iterator_t = typename Layout::template iterator<V>;
+  using pointers = std::tuple<iterator_t<typename Cs::value_type>...>;
+
+  template <class K> using index = column_index<K, columns>;
+  template <class K> using value_t = column_value_t<K, columns>;
+
+  static constexpr size_type max_alignment() noexcept {
+    constexpr size_type alignments[] = {alignof(typename Cs::value_type)...};
+    size_type result = 1;
+    for (auto a : alignments) { result = a > result ? a : result; }
+    return result;
+  }
+
+  static_assert(no_columns > 0, "cannot store a type without data members");
+  static_assert(max_alignment() <= alignof(block_type),
+                "over-aligned data members are not supported");
+
+ public:
+  /// \name Constructors
+  ///@{
+  column_arena() noexcept { reset(); }
+  column_arena(const column_arena& other)
+      : alloc_(allocator_traits::select_on_container_copy_construction(
+            other.alloc_)) {
+    reset();
+    reserve(other.size_);
+    try {
+      for_each_column_or_undo(columns{}, [&](auto c) {
+        using K = typename decltype(c)::key;
+        std::uninitialized_copy(other.template begin<K>(),
+                                other.template end<K>(), begin<K>());
+      }, [&](auto c) {
+        destroy_n(begin<typename decltype(c)::key>(), other.size_);
+      });
+    } catch (...) {
+      deallocate(buffer_, capacity_);
+      throw;
+    }
+    size_ = other.size_;
+  }
+  column_arena(column_arena&& other) noexcept(nothrow_move)
+      : alloc_(other.alloc_) {
+    reset();
+    steal(other);
+  }
+  column_arena& operator=(column_arena other) noexcept(nothrow_move) {
+    swap(*this, other);
+    return *this;
+  }
+  ~column_arena() {
+    destroy(0, size_);
+    deallocate(buffer_, capacity_);
+  }
+  ///@}
+
+  /// \name Column access
+  ///@{
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  column_type<value_t<K>> column() noexcept {
+    return {begin<K>(), size_};
+  }
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  column_type<const value_t<K>> column() const noexcept {
+    return {begin<K>(), size_};
+  }
+
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  iterator_t<value_t<K>> begin() noexcept {
+    return std::get<index<K>::value>(columns_);
+  }
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  iterator_t<const value_t<K>> begin() const noexcept {
+    return std::get<index<K>::value>(columns_);
+  }
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  iterator_t<value_t<K>> end() noexcept { return begin<K>() + size_; }
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  iterator_t<const value_t<K>> end() const noexcept {
+    return begin<K>() + size_;
+  }
+
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  value_t<K>& at(const size_type i) noexcept { return begin<K>()[i]; }
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  value_t<K> const& at(const size_type i) const noexcept {
+    return begin<K>()[i];
+  }
+
+  /// \brief Offset in bytes of the column K from the start of the buffer
+  template <class K> size_type offset() const noexcept {
+    return Layout::offsets(capacity_)[index<K>::value];
+  }
+  ///@}
+
+  /// \name Capacity
+  ///@{
+  size_type size() const noexcept { return size_; }
+  size_type capacity() const noexcept { return capacity_; }
+  size_type max_size() const noexcept {
+    const auto max_blocks = std::min
+        (allocator_traits::max_size(alloc_),
+         std::numeric_limits<size_type>::max() / sizeof(block_type));
+    return Layout::max_size(max_blocks * sizeof(block_type));
+  }
+  void reserve(const size_type n) {
+    if (n > capacity_) { reallocate(Layout::capacity(n)); }
+  }
+  void shrink_to_fit() {
+    const auto n = Layout::capacity(size_) > inline_capacity
+                       ? Layout::capacity(size_)
+                       : inline_capacity;
+    if (n != capacity_) { reallocate(n); }
+  }
+  ///@}
+
+  /// \name Modifiers
+  ///@{
+  void clear() noexcept { resize_down(0); }
+  void resize(const size_type n) {
+    if (n <= size_) {
+      resize_down(n);
+      return;
+    }
+    grow(n);
+    for_each_column_or_undo(columns{}, [&](auto c) {
+      using K = typename decltype(c)::key;
+      using V = value_t<K>;
+      const auto first = begin<K>() + size_;
+      size_type i = 0;
+      try {
+        for (; i != n - size_; ++i) {
+          ::new (static_cast<void*>(std::addressof(first[i]))) V();
+        }
+      } catch (...) {
+        destroy_n(first, i);
+        throw;
+      }
+    }, [&](auto c) {
+      destroy_n(begin<typename decltype(c)::key>() + size_, n - size_);
+    });
+    size_ = n;
+  }
+  /// \brief Inserts n value-initialized rows before the row pos
+  void insert(const size_type pos, const size_type n) {
+    ASSERT(pos <= size_, "insert position out of bounds");
+    const auto old_size = size_;
+    resize(size_ + n);
+    for_each_column(columns{}, [&](auto c) {
+      using K = typename decltype(c)::key;
+      const auto first = begin<K>();
+      std::move_backward(first + pos, first + old_size, first + old_size + n);
+      std::fill(first + pos, first + pos + n, value_t<K>());
+    });
+  }
+  /// \brief Erases the rows [pos, pos + n)
+  void erase(const size_type pos, const size_type n) {
+    ASSERT(pos + n <= size_, "erase range out of bounds");
+    for_each_column(columns{}, [&](auto c) {
+      using K = typename decltype(c)::key;
+      const auto first = begin<K>();
+      std::move(first + pos + n, first + size_, first + pos);
+    });
+    resize_down(size_ - n);
+  }
+  /// \brief Appends a row whose column C is constructed from f(C{})
+  template <class F> void emplace_back(F&& f) {
+    grow(size_ + 1);
+    for_each_column_or_undo(columns{}, [&](auto c) {
+      using K = typename decltype(c)::key;
+      ::new (static_cast<void*>(std::addressof(*end<K>()))) value_t<K>(f(c));
+    }, [&](auto c) { destroy_n(end<typename decltype(c)::key>(), 1); });
+    ++size_;
+  }
+  void pop_back() noexcept {
+    ASSERT(size_ > 0, "pop_back on empty arena");
+    resize_down(size_ - 1);
+  }
+  /// If moving an inline row throws, a and b are left in a valid but
+  /// unspecified state.
+  inline friend void swap(column_arena& a,
+                          column_arena& b) noexcept(nothrow_move) {
+    if (a.is_inline() || b.is_inline()) {
+      // The inline rows cannot be exchanged by swapping pointers:
+      column_arena tmp(std::move(a));
+      a.steal(b);
+      b.steal(tmp);
+      return;
+    }
+    using std::swap;
+    swap(a.alloc_, b.alloc_);
+    swap(a.buffer_, b.buffer_);
+    swap(a.size_, b.size_);
+    swap(a.capacity_, b.capacity_);
+    swap(a.columns_, b.columns_);
+  }
+  ///@}
+
+  /// \brief Are the rows stored inside the arena object?
+  bool is_inline() const noexcept {
+    return inline_capacity != 0 && buffer_ == inline_buffer();
+  }
+
+ private:
+  allocator_type alloc_;
+  block_type* buffer_ = nullptr;
+  size_type size_ = 0;
+  size_type capacity_ = 0;
+  pointers columns_{};  ///< Iterators to the first element of each column
+
+  /// \brief Number of blocks of a buffer of n rows
+  static size_type blocks(const size_type n) noexcept {
+    return arena_blocks<Layout>(n);
+  }
+
+  /// \brief Inline buffer (nullptr if inline_capacity is zero)
+  block_type* inline_buffer() const noexcept {
+    return const_cast<column_arena*>(this)->inline_base::inline_data();
+  }
+
+  /// \brief Makes the arena empty, with the inline buffer as its buffer
+  ///
+  /// The rows and the buffer must have been released before.
+  void reset() noexcept {
+    buffer_ = inline_buffer();
+    size_ = 0;
+    capacity_ = inline_capacity;
+    columns_ = columns_of(buffer_, capacity_);
+  }
+
+  /// \brief Takes the rows of other and leaves it empty (*this must be empty
+  /// and use its inline buffer)
+  ///
+  /// A heap buffer of other is taken over, inline rows are moved. If moving
+  /// a row throws, *this is left empty and other keeps its rows (the moved
+  /// ones in a valid but unspecified state).
+  void steal(column_arena& other) noexcept(nothrow_move) {
+    ASSERT(size_ == 0 && (inline_capacity == 0 || is_inline()),
+           "steal into a non-empty arena");
+    if (!other.is_inline()) {
+      alloc_ = other.alloc_;
+      buffer_ = other.buffer_;
+      size_ = other.size_;
+      capacity_ = other.capacity_;
+      columns_ = other.columns_;
+      other.reset();
+      return;
+    }
+    for_each_column_or_undo(columns{}, [&](auto c) {
+      using K = typename decltype(c)::key;
+      std::uninitialized_copy(
+          std::make_move_iterator(other.template begin<K>()),
+          std::make_move_iterator(other.template end<K>()), begin<K>());
+    }, [&](auto c) {
+      destroy_n(begin<typename decltype(c)::key>(), other.size_);
+    });
+    size_ = other.size_;
+    other.destroy(0, other.size_);
+    other.size_ = 0;
+  }
+
+  /// \brief Iterators to the first element of each column of a buffer of n
+  /// rows
+  static pointers columns_of(block_type* buffer, const size_type n) {
+    pointers result{};
+    if (!buffer) { return result; }
+    const auto offs = Layout::offsets(n);
+    for_each_column(columns{}, [&](auto c) {
+      using K = typename decltype(c)::key;
+      std::get<index<K>::value>(result)
+          = Layout::template make_iterator<value_t<K>>(
+              reinterpret_cast<char*>(buffer) + offs[index<K>::value]);
+    });
+    return result;
+  }
+
+  /// \brief Destroys the rows [first, last) of every column
+  void destroy(const size_type first, const size_type last) noexcept {
+    for_each_column(columns{}, [&](auto c) {
+      destroy_n(begin<typename decltype(c)::key>() + first, last - first);
+    });
+  }
+
+  void deallocate(block_type* buffer, const size_type n) noexcept {
+    if (buffer && buffer != inline_buffer()) {
+      allocator_traits::deallocate(alloc_, buffer, blocks(n));
+    }
+  }
+
+  void resize_down(const size_type n) noexcept {
+    ASSERT(n <= size_, "resize_down cannot grow the arena");
+    destroy(n, size_);
+    size_ = n;
+  }
+
+  /// \brief Makes room for at least n rows with geometric growth
+  void grow(const size_type n) {
+    if (n > capacity_) {
+      reallocate(Layout::capacity(std::max(n, 2 * capacity_)));
+    }
+  }
+
+  /// \brief Moves the rows into a new buffer of n >= size() rows (the inline
+  /// buffer if n == inline_capacity)
+  void reallocate(const size_type n) {
+    ASSERT(n >= size_, "reallocate cannot drop rows");
+    ASSERT(n >= inline_capacity, "reallocate below the inline capacity");
+    block_type* buffer = n == inline_capacity
+                             ? inline_buffer()
+                             : allocator_traits::allocate(alloc_, blocks(n));
+    auto cols = columns_of(buffer, n);
+    try {
+      for_each_column_or_undo(columns{}, [&](auto c) {
+        using K = typename decltype(c)::key;
+        std::uninitialized_copy(std::make_move_iterator(begin<K>()),
+                                std::make_move_iterator(end<K>()),
+                                std::get<index<K>::value>(cols));
+      }, [&](auto c) {
+        destroy_n(std::get<index<typename decltype(c)::key>::value>(cols),
+                  size_);
+      });
+    } catch (...) {
+      deallocate(buffer, n);
+      throw;
+    }
+    destroy(0, size_);
+    deallocate(buffer_, capacity_);
+    buffer_ = buffer;
+    capacity_ = n;
+    columns_ = cols;
+  }
+};
+
+}  // namespace detail
+
+/// \brief Storage policy: all columns are stored in a single allocation
+///
+/// Compared to container_storage, growing the vector performs one allocation
+/// and one capacity check instead of one per column, and the columns of
+/// a vector are contiguous in memory.
+template <class Allocator = std::allocator<char>> struct arena_storage {
+  template <class Columns>
+  using storage_type = detail::column_arena
+      <Columns, detail::contiguous_layout<Columns>, Allocator>;
+};
+
+}  // namespace scattered
+
+#endif  // SCATTERED_DETAIL_COLUMN_ARENA_HPP
@@ -0,0 +1,138 @@
+// (C) Copyright Gonzalo Brito Gadeschi 2014
+// Use, modification and distribution are subject to the Boost Software License,
+// Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt).
+
+/// \file \brief Compile-time column lists of adapted structs
+
+#if !defined(SCATTERED_DETAIL_COLUMNS_HPP)
+#define SCATTERED_DETAIL_COLUMNS_HPP
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <boost/fusion/sequence/intrinsic/begin.hpp>
+#include <boost/fusion/sequence/intrinsic/size.hpp>
+#include <boost/fusion/iterator/advance.hpp>
+#include <boost/fusion/iterator/key_of.hpp>
+#include <boost/fusion/iterator/value_of_data.hpp>
+
+namespace scattered {
+
+namespace detail {
+
+/// \brief Column storing the data member of key K (of type V)
+template <class K, class V> struct column {
+  using key = K;
+  using value_type = V;
+};
+
+/// \brief Ordered list of columns
+template <class... Cs> struct column_list {
+  static const constexpr std::size_t size = sizeof...(Cs);
+};
+
+/// \brief I-th data member of the associative fusion sequence T as a column
+template <class T, std::size_t I> struct column_at {
+  using first = typename boost::fusion::result_of::begin<T>::type;
+  using it = typename boost::fusion::result_of::advance_c<first, I>::type;
+  using type = column<typename boost::fusion::result_of::key_of<it>::type,
+                      typename boost::fusion::result_of::value_of_data
+                      <it>::type>;
+};
+
+template <class T, class Is> struct columns_of_impl;
+template <class T, std::size_t... Is>
+struct columns_of_impl<T, std::index_sequence<Is...>> {
+  using type = column_list<typename column_at<T, Is>::type...>;
+};
+
+/// \brief T -> column_list<column<key0, T.member0>..column<keyN, T.memberN>>
+template <class T> struct columns_of {
+  using type = typename columns_of_impl
+      <T, std::make_index_sequence
+          <boost::fusion::result_of::size<T>::type::value>>::type;
+};
+
+template <class T> using columns_of_t = typename columns_of<T>::type;
+
+/// \brief Position of K in the list of keys Ks (sizeof...(Ks) if not found)
+template <class K, class... Ks> constexpr std::size_t index_of() noexcept {
+  constexpr bool matches[] = {false, std::is_same<K, Ks>::value...};
+  for (std::size_t i = 1; i != sizeof...(Ks) + 1; ++i) {
+    if (matches[i]) { return i - 1; }
+  }
+  return sizeof...(Ks);
+}
+
+/// \brief Position of the column with key K in the column list L
+template <class K, class L> struct column_index;
+template <class K, class... Cs>
+struct column_index<K, column_list<Cs...>>
+    : std::integral_constant
+      <std::size_t, index_of<K, typename Cs::key...>()> {
+  static_assert(column_index::value != sizeof...(Cs),
+                "key is not a column of the container");
+};
+
+/// \brief Type of the column with key K in the column list L
+template <class K, class L> struct column_value;
+template <class K, class... Cs> struct column_value<K, column_list<Cs...>> {
+  using type = typename std::tuple_element
+      <column_index<K, column_list<Cs...>>::value,
+       std::tuple<typename Cs::value_type...>>::type;
+};
+
+template <class K, class L>
+using column_value_t = typename column_value<K, L>::type;
+
+/// \brief Columns of the keys Ks of the column list L (in the order of Ks)
+template <class L, class... Ks>
+using projected_columns = column_list<column<Ks, column_value_t<Ks, L>>...>;
+
+/// \brief Columns of the keys Ks of the column list L, or L if there are no
+/// keys
+template <class L, class... Ks> struct selected_columns {
+  using type = projected_columns<L, Ks...>;
+};
+template <class L> struct selected_columns<L> { using type = L; };
+
+template <class L, class... Ks>
+using selected_columns_t = typename selected_columns<L, Ks...>::type;
+
+/// \brief Are the values of all the columns of the list nothrow move
+/// constructible
+template <class L> struct nothrow_move_constructible_columns;
+template <class... Cs>
+struct nothrow_move_constructible_columns<column_list<Cs...>>
+    : std::is_same<std::integer_sequence
+                   <bool, true, std::is_nothrow_move_constructible
+                                <typename Cs::value_type>::value...>,
+                   std::integer_sequence
+                   <bool, std::is_nothrow_move_constructible
+                          <typename Cs::value_type>::value...,
+                    true>> {};
+
+/// \brief Calls f(Cs{}) for each column in the list
+template <class F, class... Cs>
+[[gnu::always_inline, gnu::hot, gnu::flatten]] inline
+void for_each_column(column_list<Cs...>, F&& f) {
+  int dummy[] = {0, (f(Cs{}), void(), 0)...};
+  (void)dummy;
+}
+
+/// \brief True if f(Cs{}) is true for all columns in the list
+template <class F, class... Cs>
+[[gnu::always_inline, gnu::hot, gnu::flatten]] inline
+bool all_columns(column_list<Cs...> l, F&& f) {
+  bool result = true;
+  for_each_column(l, [&](auto c) { result = result && f(c); });
+  return result;
+}
+
+}  // namespace detail
+
+}  // namespace scattered
+
+#endif  // SCATTERED_DETAIL_COLUMNS_HPP
@@ -0,0 +1,242 @@
+// (C) Copyright Gonzalo Brito Gadeschi 2014
+// Use, modification and distribution are subject to the Boost Software License,
+// Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt).
+
+/// \file \brief Storage with one container per column
+
+#if !defined(SCATTERED_DETAIL_CONTAINER_STORAGE_HPP)
+#define SCATTERED_DETAIL_CONTAINER_STORAGE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <boost/container/vector.hpp>
+#include <boost/fusion/support/pair.hpp>
+#include <boost/fusion/container/map.hpp>
+#include <boost/fusion/sequence/intrinsic/at_c.hpp>
+#include <boost/fusion/sequence/intrinsic/at_key.hpp>
+#include <boost/fusion/algorithm/iteration/for_each.hpp>
+#include "aligned_allocator.hpp"
+#include "bit_vector.hpp"
+#include "huge_page_allocator.hpp"
+#include "columns.hpp"
+#include "unqualified.hpp"
+
+namespace scattered {
+
+/// \brief Vector of T (bool columns are packed in a bit_vector)
+template <class T>
+using default_vector_container = std::conditional_t
+    <std::is_same<T, bool>::value, bit_vector<>,
+     boost::container::vector<T, std::allocator<T>>>;
+
+/// \brief Vector whose buffer is aligned to Alignment bytes and padded to a
+/// multiple of Width elements (see aligned_allocator)
+template <std::size_t Alignment, std::size_t Width>
+struct aligned_vector_container {
+  template <class T>
+  using type = boost::container::vector
+      <T, aligned_allocator<T, Alignment, Width>>;
+};
+
+/// \brief Vector whose large buffers are backed by huge pages (see
+/// huge_page_allocator); bool columns are packed in a bit_vector
+template <huge_pages Pages, bool Prefault> struct huge_page_vector_container {
+  template <class T>
+  using type = std::conditional_t
+      <std::is_same<T, bool>::value,
+       bit_vector<huge_page_allocator<std::uint64_t, Pages, Prefault>>,
+       boost::container::vector<T, huge_page_allocator<T, Pages, Prefault>>>;
+};
+
+namespace detail {
+
+/// \brief Stores each column in its own Container
+///
+/// Every column has its own size, capacity and allocation. All column
+/// containers are kept at the same size.
+template <class Columns, template <class> class Container>
+class container_storage;
+
+template <class... Cs, template <class> class Container>
+class container_storage<column_list<Cs...>, Container> {
+ public:
+  using columns = column_list<Cs...>;
+  using size_type = std::size_t;
+  template <class U> using column_type = Container<U>;
+  /// (key0..keyN) -> (Container<T.member0>..Container<T.memberN>)
+  using data_type = boost::fusion::map
+      <boost::fusion::pair
+       <typename Cs::key, Container<typename Cs::value_type>>...>;
+
+  /// \name Column access
+  ///@{
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  data_type& data() noexcept { return data_; }
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  data_type const& data() const noexcept { return data_; }
+
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  auto& column() noexcept { return boost::fusion::at_key<K>(data_); }
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  auto const& column() const noexcept {
+    return boost::fusion::at_key<K>(data_);
+  }
+
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  auto begin() noexcept { return column<K>().begin(); }
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  auto begin() const noexcept { return column<K>().cbegin(); }
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  auto end() noexcept { return column<K>().end(); }
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  auto end() const noexcept { return column<K>().cend(); }
+
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  decltype(auto) at(const size_type i) noexcept { return column<K>()[i]; }
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  decltype(auto) at(const size_type i) const noexcept {
+    return column<K>()[i];
+  }
+  ///@}
+
+  /// \name Capacity
+  ///@{
+  size_type size() const noexcept {
+    return boost::fusion::at_c<0>(data_).second.size();
+  }
+  /// \brief Number of rows that fit in all the columns without reallocating
+  ///
+  /// The column containers can round their capacity up differently (e.g. a
+  /// bit_vector to a multiple of 64 rows), so this is the smallest one.
+  size_type capacity() const noexcept {
+    size_type result = std::numeric_limits<size_type>::max();
+    boost::fusion::for_each(data_, [&](auto const& i) {
+      const size_type c = i.second.capacity();
+      result = c < result ? c : result;
+    });
+    return result;
+  }
+  size_type max_size() const noexcept {
+    return boost::fusion::at_c<0>(data_).second.max_size();
+  }
+  void reserve(const size_type n) {
+    boost::fusion::for_each(data_, [&](auto& i) { i.second.reserve(n); });
+  }
+  void shrink_to_fit() {
+    boost::fusion::for_each(data_, [](auto& i) { i.second.shrink_to_fit(); });
+  }
+  ///@}
+
+  /// \name Modifiers
+  ///@{
+  void clear() noexcept {
+    boost::fusion::for_each(data_, [](auto& i) { i.second.clear(); });
+  }
+  void resize(const size_type n) {
+    boost::fusion::for_each(data_, [&](auto& i) { i.second.resize(n); });
+  }
+  /// \brief Inserts n value-initialized rows before the row pos
+  void insert(const size_type pos, const size_type n) {
+    boost::fusion::for_each(data_, [&](auto& i) {
+      using value_type = typename unqualified_t<decltype(i.second)>::value_type;
+      i.second.insert(i.second.cbegin() + pos, n, value_type());
+    });
+  }
+  /// \brief Erases the rows [pos, pos + n)
+  void erase(const size_type pos, const size_type n) {
+    boost::fusion::for_each(data_, [&](auto& i) {
+      const auto first = i.second.cbegin() + pos;
+      i.second.erase(first, first + n);
+    });
+  }
+  /// \brief Appends a row whose column C is constructed from f(C{})
+  template <class F> void emplace_back(F&& f) {
+    for_each_column(columns{}, [&](auto c) {
+      column<typename decltype(c)::key>().emplace_back(f(c));
+    });
+  }
+  void pop_back() {
+    boost::fusion::for_each(data_, [](auto& i) { i.second.pop_back(); });
+  }
+  /// \brief Swaps the column containers (which exchanges their buffers)
+  inline friend void swap(container_storage& a,
+                          container_storage& b) noexcept {
+    for_each_column(columns{}, [&](auto c) {
+      using K = typename decltype(c)::key;
+      using std::swap;
+      swap(a.template column<K>(), b.template column<K>());
+    });
+  }
+  ///@}
+
+ private:
+  data_type data_;
+};
+
+/// \brief container_storage with aligned and padded columns
+template <class Columns, std::size_t Alignment, std::size_t Width>
+struct aligned_container_storage
+    : container_storage
+      <Columns,
+       aligned_vector_container<Alignment, Width>::template type> {
+  /// Alignment in bytes of the first element of every column
+  static const constexpr std::size_t alignment = Alignment;
+  /// Every column can be accessed up to a multiple of width elements
+  static const constexpr std::size_t width = Width;
+};
+
+}  // namespace detail
+
+/// \brief Storage policy: each column is stored in its own Container
+///
+/// This is the default storage of scattered::vector.
+template <template <class> class Container = default_vector_container>
+struct container_storage {
+  template <class Columns>
+  using storage_type = detail::container_storage<Columns, Container>;
+};
+
+/// \brief Storage policy: each column is stored in its own vector, aligned to
+/// Alignment bytes and padded to a multiple of Width elements
+///
+/// Kernels can rely on the compile-time constants alignment and width (also
+/// available as vector<T, aligned_container_storage<A, W>>::storage_type::
+/// alignment and ::width) to use aligned loads and to process the last
+/// elements of a column with a full SIMD vector, without peel and remainder
+/// loops.
+template <std::size_t Alignment = 64, std::size_t Width = 1>
+struct aligned_container_storage {
+  static const constexpr std::size_t alignment = Alignment;
+  static const constexpr std::size_t width = Width;
+  template <class Columns>
+  using storage_type
+      = detail::aligned_container_storage<Columns, Alignment, Width>;
+};
+
+/// \brief Storage policy: each column is stored in its own vector, and the
+/// buffers of large columns are backed by huge pages
+///
+/// Pages selects transparent (madvise) or explicit (hugetlb) huge pages, and
+/// Prefault faults the pages in on allocation (see huge_page_allocator). For
+/// a single allocation backed by huge pages use
+/// arena_storage<huge_page_allocator<char, Pages, Prefault>>.
+template <huge_pages Pages = huge_pages::madvise, bool Prefault = false>
+using huge_page_storage = container_storage
+    <huge_page_vector_container<Pages, Prefault>::template type>;
+
+}  // namespace scattered
+
+#endif  // SCATTERED_DETAIL_CONTAINER_STORAGE_HPP
@@ -0,0 +1,98 @@
+// (C) Copyright Gonzalo Brito Gadeschi 2014
+// Use, modification and distribution are subject to the Boost Software License,
+// Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt).
+
+/// \file \brief Bulk erasure of the rows of a scattered vector
+
+#if !defined(SCATTERED_DETAIL_ERASE_HPP)
+#define SCATTERED_DETAIL_ERASE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <boost/iterator/counting_iterator.hpp>
+#include "assert.hpp"
+#include "columns.hpp"
+#include "executor.hpp"
+#include "mask.hpp"
+#include "vector.hpp"
+
+namespace scattered {
+
+namespace detail {
+
+/// \brief Moves the elements [first, first + m.size()) whose bit in m is not
+/// set to the front of the range (in order), and returns their number
+///
+/// The mask is read a word at a time: runs of 64 kept elements are moved at
+/// once, and runs of 64 erased elements are skipped.
+template <class It> std::size_t compact(It first, const mask_type& m) {
+  using word_type = mask_type::word_type;
+  const std::size_t n = m.size();
+  const word_type* words = m.words();
+  std::size_t out = 0;
+  for (std::size_t i = 0; i < n; i += bits_per_word) {
+    const std::size_t last = i + bits_per_word < n ? i + bits_per_word : n;
+    const word_type w = words[i / bits_per_word];
+    if (w == 0) {
+      if (out != i) { std::move(first + i, first + last, first + out); }
+      out += last - i;
+    } else if (~w != 0) {
+      for (std::size_t j = i; j != last; ++j) {
+        if (!((w >> (j - i)) & 1)) {
+          if (out != j) { first[out] = std::move(first[j]); }
+          ++out;
+        }
+      }
+    }
+  }
+  return out;
+}
+
+}  // namespace detail
+
+/// \brief Erases the rows of v whose bit in m is set, and returns their number
+///
+/// Each column is compacted independently in a single streaming pass, with
+/// the columns compacted in parallel as tasks of the executor e (or of a
+/// thread_executor if e is a number of threads). The remaining rows keep
+/// their order.
+template <class T, class S, class Executor = thread_executor>
+std::size_t erase_mask(vector<T, S>& v, const mask_type& m,
+                       Executor&& e = Executor{}) {
+  ASSERT(m.size() == v.size(), "the mask must have a bit per row");
+  using columns = typename vector<T, S>::storage_type::columns;
+  const std::size_t n = v.size();
+  const std::size_t kept = n - m.count();
+  if (kept == n) { return 0; }
+  detail::parallel_for_each_column(
+      columns{}, detail::as_executor(std::forward<Executor>(e)), [&](auto c) {
+        using K = typename decltype(c)::key;
+        detail::compact(v.storage().template begin<K>(), m);
+      });
+  v.resize(kept);
+  return n - kept;
+}
+
+/// \brief Erases the rows i of v for which pred(get<Ks>(v, i)...) is true,
+/// and returns their number
+///
+/// Only the columns Ks are read to evaluate the predicate, which builds a
+/// bitmask of the rows to erase (see erase_mask). For example,
+///
+///   erase_if<k::alive>(v, [](bool alive) { return !alive; });
+template <class... Ks, class T, class S, class P,
+          class Executor = thread_executor>
+std::size_t erase_if(vector<T, S>& v, P&& pred, Executor&& e = Executor{}) {
+  static_assert(sizeof...(Ks) > 0, "the predicate needs at least one column");
+  const auto& s = v.storage();
+  const auto m = detail::make_mask(
+      boost::counting_iterator<std::size_t>(0), v.size(),
+      [&](std::size_t i) { return pred(s.template at<Ks>(i)...); });
+  return erase_mask(v, m, std::forward<Executor>(e));
+}
+
+}  // namespace scattered
+
+#endif  // SCATTERED_DETAIL_ERASE_HPP
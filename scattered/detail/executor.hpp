@@ -0,0 +1,275 @@
+// (C) Copyright Gonzalo Brito Gadeschi 2014
+// Use, modification and distribution are subject to the Boost Software License,
+// Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt).
+
+/// \file \brief Executors for the parallel algorithms
+///
+/// An executor e provides
+///
+///   e.parallel_for(n, grain, f)
+///
+/// which calls f(first, last) for disjoint chunks [first, last) covering
+/// [0, n), whose boundaries are multiples of grain (or n), and returns once
+/// every chunk is done, rethrowing the first exception thrown by f if any,
+/// and optionally e.no_threads(), the number of threads it runs tasks on.
+/// Any type providing these members (e.g. a wrapper around a thread pool) can
+/// be passed to the algorithms that take an executor. Most algorithms also
+/// accept a number of threads instead, meaning thread_executor{no_threads}.
+
+#if !defined(SCATTERED_DETAIL_EXECUTOR_HPP)
+#define SCATTERED_DETAIL_EXECUTOR_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "columns.hpp"
+#include "parallel.hpp"
+
+namespace scattered {
+
+/// \brief Executor that runs everything on the calling thread
+struct sequential_executor {
+  std::size_t no_threads() const noexcept { return 1; }
+  template <class F>
+  void parallel_for(const std::size_t n, const std::size_t, F&& f) const {
+    if (n != 0) { f(std::size_t(0), n); }
+  }
+};
+
+/// \brief Executor that forks no_threads threads per call (including the
+/// calling thread) and joins them before returning
+class thread_executor {
+ public:
+  explicit thread_executor(
+      const std::size_t no_threads = detail::default_no_threads()) noexcept
+      : no_threads_(no_threads > 0 ? no_threads : 1) {}
+  std::size_t no_threads() const noexcept { return no_threads_; }
+  template <class F>
+  void parallel_for(const std::size_t n, const std::size_t grain,
+                    F&& f) const {
+    detail::parallel_for(n, no_threads_, grain, std::forward<F>(f));
+  }
+
+ private:
+  std::size_t no_threads_;
+};
+
+/// \brief Executor with a pool of threads that balance the load by stealing
+/// each other's work
+///
+/// Each thread has a deque of row ranges. A thread splits the range it runs
+/// in halves (at multiples of the grain) until it is small enough, pushing
+/// the upper halves to the back of its deque, and runs the ranges at the
+/// back of its deque first. Idle threads steal from the front of the other
+/// deques, i.e. the largest ranges, so that uneven per-row costs do not leave
+/// threads idle at the end of a loop.
+///
+/// The thread calling parallel_for runs ranges until its loop is done
+/// instead of blocking, so nested loops (e.g. a parallel_for over the rows
+/// inside a for_each_column task) run on the threads of the pool without
+/// oversubscribing the machine. The pool has no_threads - 1 threads, and
+/// the calling thread is the remaining one.
+class work_stealing_executor {
+  /// A parallel_for call
+  struct job {
+    std::function<void(std::size_t, std::size_t)> f;
+    std::size_t chunk;  ///< Ranges are split until they are this small
+    std::atomic<std::size_t> remaining;  ///< Rows not run yet
+    std::mutex error_mutex;
+    std::exception_ptr error;
+  };
+  /// Range of rows of a job
+  struct task {
+    job* j;
+    std::size_t first, last;
+  };
+  struct task_queue {
+    std::mutex mutex;
+    std::deque<task> tasks;
+  };
+
+ public:
+  explicit work_stealing_executor(
+      const std::size_t no_threads = detail::default_no_threads()) {
+    const std::size_t n = no_threads > 0 ? no_threads : 1;
+    // The queue 0 is used by the threads that are not in the pool
+    for (std::size_t i = 0; i != n; ++i) {
+      queues_.emplace_back(std::make_unique<task_queue>());
+    }
+    for (std::size_t i = 1; i != n; ++i) {
+      threads_.emplace_back([this, i]() { work(i); });
+    }
+  }
+  work_stealing_executor(const work_stealing_executor&) = delete;
+  work_stealing_executor& operator=(const work_stealing_executor&) = delete;
+  ~work_stealing_executor() {
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& t : threads_) { t.join(); }
+  }
+
+  std::size_t no_threads() const noexcept { return queues_.size(); }
+
+  template <class F>
+  void parallel_for(const std::size_t n, const std::size_t grain,
+                    F&& f) const {
+    if (n == 0) { return; }
+    job j;
+    j.f = [&f](std::size_t first, std::size_t last) { f(first, last); };
+    j.chunk = detail::chunk_size(n, 4 * no_threads(), grain > 0 ? grain : 1);
+    j.remaining = n;
+    const std::size_t s = slot();
+    run(s, task{&j, 0, n});
+    task t;
+    while (j.remaining.load() != 0) {
+      if (try_pop(s, t)) {
+        run(s, t);
+      } else {
+        std::this_thread::yield();
+      }
+    }
+    if (j.error) { std::rethrow_exception(j.error); }
+  }
+
+ private:
+  std::vector<std::unique_ptr<task_queue>> queues_;
+  std::vector<std::thread> threads_;
+  mutable std::atomic<std::size_t> no_queued_{0};
+  mutable std::mutex sleep_mutex_;
+  mutable std::condition_variable wake_;
+  bool stop_ = false;
+
+  /// \brief Pool and queue of the calling thread
+  static std::pair<const work_stealing_executor*, std::size_t>& current() {
+    thread_local std::pair<const work_stealing_executor*, std::size_t> c{
+        nullptr, 0};
+    return c;
+  }
+  std::size_t slot() const noexcept {
+    const auto& c = current();
+    return c.first == this ? c.second : 0;
+  }
+
+  void push(const std::size_t s, const task t) const {
+    {
+      std::lock_guard<std::mutex> lock(queues_[s]->mutex);
+      queues_[s]->tasks.push_back(t);
+      ++no_queued_;
+    }
+    { std::lock_guard<std::mutex> lock(sleep_mutex_); }
+    wake_.notify_one();
+  }
+  /// \brief Pops from the back of the queue s, or steals from the front of
+  /// another queue
+  bool try_pop(const std::size_t s, task& t) const {
+    const std::size_t n = queues_.size();
+    for (std::size_t i = 0; i != n; ++i) {
+      auto& q = *queues_[(s + i) % n];
+      std::lock_guard<std::mutex> lock(q.mutex);
+      if (q.tasks.empty()) { continue; }
+      if (i == 0) {
+        t = q.tasks.back();
+        q.tasks.pop_back();
+      } else {
+        t = q.tasks.front();
+        q.tasks.pop_front();
+      }
+      --no_queued_;
+      return true;
+    }
+    return false;
+  }
+  void run(const std::size_t s, task t) const {
+    job& j = *t.j;
+    while (t.last - t.first > j.chunk) {
+      const std::size_t half = (t.last - t.first + 1) / 2;
+      const std::size_t mid = t.first + (half + j.chunk - 1) / j.chunk
+                                            * j.chunk;
+      push(s, task{t.j, mid, t.last});
+      t.last = mid;
+    }
+    try {
+      j.f(t.first, t.last);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(j.error_mutex);
+      if (!j.error) { j.error = std::current_exception(); }
+    }
+    // The job can be destroyed as soon as no rows remain:
+    j.remaining -= t.last - t.first;
+  }
+  void work(const std::size_t s) {
+    current() = {this, s};
+    task t;
+    for (;;) {
+      if (try_pop(s, t)) {
+        run(s, t);
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(sleep_mutex_);
+      wake_.wait(lock, [&]() { return stop_ || no_queued_ > 0; });
+      if (stop_ && no_queued_ == 0) { return; }
+    }
+  }
+};
+
+namespace detail {
+
+/// \brief An executor, or a thread_executor with no_threads threads
+template <class E,
+          std::enable_if_t<!std::is_integral<std::decay_t<E>>::value, int> = 0>
+E&& as_executor(E&& e) noexcept {
+  return std::forward<E>(e);
+}
+template <class N,
+          std::enable_if_t<std::is_integral<std::decay_t<N>>::value, int> = 0>
+thread_executor as_executor(const N no_threads) noexcept {
+  return thread_executor{static_cast<std::size_t>(no_threads)};
+}
+
+/// \brief Number of threads of the executor e (one per hardware thread if it
+/// does not tell)
+template <class E>
+auto no_threads_of(const E& e, int) -> decltype(std::size_t(e.no_threads())) {
+  return e.no_threads();
+}
+template <class E> std::size_t no_threads_of(const E&, long) {
+  return default_no_threads();
+}
+template <class E> std::size_t no_threads_of(const E& e) {
+  return no_threads_of(e, 0);
+}
+
+/// \brief Calls f(Cs{}) for each column of the list as a separate task of the
+/// executor e
+///
+/// Each column is processed by a single task, so that tasks never write to
+/// the same column.
+template <class... Cs, class Executor, class F>
+void parallel_for_each_column(column_list<Cs...>, Executor&& e, F&& f) {
+  std::vector<std::function<void()>> tasks;
+  tasks.reserve(sizeof...(Cs));
+  for_each_column(column_list<Cs...>{},
+                  [&](auto c) { tasks.emplace_back([&f, c]() { f(c); }); });
+  e.parallel_for(tasks.size(), 1, [&](std::size_t i, std::size_t l) {
+    for (; i != l; ++i) { tasks[i](); }
+  });
+}
+
+}  // namespace detail
+
+}  // namespace scattered
+
+#endif  // SCATTERED_DETAIL_EXECUTOR_HPP
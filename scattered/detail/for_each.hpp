@@ -0,0 +1,138 @@
+// (C) Copyright Gonzalo Brito Gadeschi 2014
+// Use, modification and distribution are subject to the Boost Software License,
+// Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt).
+
+/// \file \brief Parallel loops over the columns and rows of a scattered vector
+
+#if !defined(SCATTERED_DETAIL_FOR_EACH_HPP)
+#define SCATTERED_DETAIL_FOR_EACH_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <boost/range/iterator_range.hpp>
+#include "columns.hpp"
+#include "executor.hpp"
+#include "vector.hpp"
+
+namespace scattered {
+
+namespace detail {
+
+/// \brief Size in bytes of a cache line
+static const constexpr std::size_t cache_line_size = 64;
+
+constexpr std::size_t gcd(const std::size_t a, const std::size_t b) noexcept {
+  return b == 0 ? a : gcd(b, a % b);
+}
+
+/// \brief Bits per element of the column K of Storage (1 for packed bools,
+/// whose iterators return proxy references)
+template <class Storage, class K> constexpr std::size_t element_bits() {
+  using iterator = decltype(std::declval<Storage&>().template begin<K>());
+  using reference = typename std::iterator_traits<iterator>::reference;
+  return std::is_lvalue_reference<reference>::value
+             ? sizeof(std::remove_reference_t<reference>) * 8
+             : 1;
+}
+
+/// \brief Smallest number of rows that spans a whole number of cache lines in
+/// every column of Storage
+///
+/// It is the least common multiple over the columns of the number of rows
+/// that span a whole number of cache lines in the column, e.g. 8 rows for a
+/// double column, 16 for a float column, and 512 for a packed bool column.
+template <class Storage, class... Cs>
+constexpr std::size_t cache_line_rows(column_list<Cs...>) {
+  constexpr std::size_t line_bits = cache_line_size * 8;
+  constexpr std::size_t bits[] = {line_bits,
+                                  element_bits<Storage, typename Cs::key>()...};
+  std::size_t result = 1;
+  for (auto b : bits) {
+    const std::size_t rows = line_bits / gcd(line_bits, b);
+    result = result / gcd(result, rows) * rows;
+  }
+  return result;
+}
+template <class Storage> constexpr std::size_t cache_line_rows() {
+  return cache_line_rows<Storage>(typename Storage::columns{});
+}
+
+}  // namespace detail
+
+/// \name Column-parallel loops
+///
+/// Since every column is stored separately, the columns of a vector can be
+/// processed concurrently without false sharing.
+///@{
+/// \brief Calls f(v.data<K>()) for each column K of Ks (every column of v if
+/// Ks is empty), each as a separate task of the executor e, and returns once
+/// every task is done
+///
+/// For example, to normalize the members x and y on two threads:
+///
+///   for_each_column<k::x, k::y>(v, [](auto&& c) { normalize(c); });
+///
+/// The executor can also be a number of threads (of a thread_executor). The
+/// exceptions thrown by f are rethrown (the first one, if several tasks
+/// throw) after every task is done.
+template <class... Ks, class T, class S, class F,
+          class Executor = thread_executor>
+void for_each_column(vector<T, S>& v, F&& f, Executor&& e = Executor{}) {
+  using columns = detail::selected_columns_t
+      <typename vector<T, S>::storage_type::columns, Ks...>;
+  detail::parallel_for_each_column(
+      columns{}, detail::as_executor(std::forward<Executor>(e)), [&](auto c) {
+        f(v.template data<typename decltype(c)::key>());
+      });
+}
+template <class... Ks, class T, class S, class F,
+          class Executor = thread_executor>
+void for_each_column(const vector<T, S>& v, F&& f, Executor&& e = Executor{}) {
+  using columns = detail::selected_columns_t
+      <typename vector<T, S>::storage_type::columns, Ks...>;
+  detail::parallel_for_each_column(
+      columns{}, detail::as_executor(std::forward<Executor>(e)), [&](auto c) {
+        f(v.template data<typename decltype(c)::key>());
+      });
+}
+///@}
+
+/// \name Row-parallel loops
+///@{
+/// \brief Calls f(rows) for disjoint ranges of rows covering v as tasks of
+/// the executor e, and returns once every task is done
+///
+/// Each range is a boost::iterator_range of proxy iterators of v. The range
+/// boundaries are multiples of detail::cache_line_rows<storage_type>(), so
+/// that when the columns start at a cache line boundary (e.g. with
+/// aligned_container_storage<64>), every boundary falls on a cache line
+/// boundary in every column at once and the tasks do not false share. For
+/// example,
+///
+///   parallel_for(v, [](auto rows) { for (auto&& r : rows) { update(r); } });
+template <class T, class S, class F, class Executor = thread_executor>
+void parallel_for(vector<T, S>& v, F&& f, Executor&& e = Executor{}) {
+  using storage_type = typename vector<T, S>::storage_type;
+  constexpr std::size_t grain = detail::cache_line_rows<storage_type>();
+  auto&& ex = detail::as_executor(std::forward<Executor>(e));
+  ex.parallel_for(v.size(), grain, [&](std::size_t first, std::size_t last) {
+    f(boost::make_iterator_range(v.begin() + first, v.begin() + last));
+  });
+}
+template <class T, class S, class F, class Executor = thread_executor>
+void parallel_for(const vector<T, S>& v, F&& f, Executor&& e = Executor{}) {
+  using storage_type = typename vector<T, S>::storage_type;
+  constexpr std::size_t grain = detail::cache_line_rows<storage_type>();
+  auto&& ex = detail::as_executor(std::forward<Executor>(e));
+  ex.parallel_for(v.size(), grain, [&](std::size_t first, std::size_t last) {
+    f(boost::make_iterator_range(v.begin() + first, v.begin() + last));
+  });
+}
+///@}
+
+}  // namespace scattered
+
+#endif  // SCATTERED_DETAIL_FOR_EACH_HPP
@@ -0,0 +1,616 @@
+// (C) Copyright Gonzalo Brito Gadeschi 2014
+// Use, modification and distribution are subject to the Boost Software License,
+// Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt).
+
+/// \file \brief Read-only vector with compressed integer columns
+
+#if !defined(SCATTERED_DETAIL_FROZEN_VECTOR_HPP)
+#define SCATTERED_DETAIL_FROZEN_VECTOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/range/iterator_range.hpp>
+#include "columns.hpp"
+#include "vector.hpp"
+
+namespace scattered {
+
+/// \brief Encoding of a compressed column of a frozen_vector
+///
+/// All encodings bit-pack a sequence of unsigned integers of width() bits.
+enum class encoding {
+  /// The value minus the minimum of the column
+  frame_of_reference,
+  /// The difference with the previous value (for non-decreasing columns)
+  delta,
+  /// The index of the value in a sorted dictionary of the distinct values
+  dictionary,
+  /// Not compressed (columns of non-integral types)
+  plain
+};
+
+namespace detail {
+
+/// Number of rows decoded at a time by for_each_block
+static const constexpr std::size_t frozen_block_size = 256;
+
+/// \brief Integral or enumeration type
+template <class V>
+using is_packable = std::integral_constant
+    <bool, std::is_integral<V>::value || std::is_enum<V>::value>;
+
+template <class V, bool = std::is_enum<V>::value> struct integral_of {
+  using type = V;
+};
+template <class V> struct integral_of<V, true> {
+  using type = std::underlying_type_t<V>;
+};
+
+/// \brief Value of V as 64 bits (the order of the differences of two values
+/// is preserved modulo 2^64)
+template <class V>
+[[gnu::always_inline, gnu::const]] inline
+std::uint64_t to_bits(const V v) noexcept {
+  using I = typename integral_of<V>::type;
+  using W = std::conditional_t<std::is_signed<I>::value, std::int64_t,
+                               std::uint64_t>;
+  return static_cast<std::uint64_t>(static_cast<W>(static_cast<I>(v)));
+}
+template <class V>
+[[gnu::always_inline, gnu::const]] inline
+V from_bits(const std::uint64_t b) noexcept {
+  using I = typename integral_of<V>::type;
+  return static_cast<V>(static_cast<I>(b));
+}
+
+/// \brief Number of bits needed to store x
+[[gnu::always_inline, gnu::const]] inline
+unsigned bit_width(const std::uint64_t x) noexcept {
+  return x == 0 ? 0 : 64 - __builtin_clzll(x);
+}
+
+/// \brief Sequence of unsigned integers of a fixed width (0 to 64 bits)
+/// packed in 64-bit words
+///
+/// The words are padded so that extracting an integer never branches on
+/// whether it straddles two words.
+class packed_ints {
+ public:
+  packed_ints() = default;
+  packed_ints(const std::size_t n, const unsigned width)
+      : width_(width),
+        mask_(width == 64 ? ~std::uint64_t(0)
+                          : (std::uint64_t(1) << width) - 1),
+        words_(n * width / 64 + 2, 0) {}
+
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  std::uint64_t operator[](const std::size_t i) const noexcept {
+    const std::size_t bit = i * width_;
+    const std::size_t w = bit / 64;
+    const unsigned offset = bit % 64;
+    // The second shift is split to avoid shifting by 64 when offset == 0:
+    return ((words_[w] >> offset) | ((words_[w + 1] << 1) << (63 - offset)))
+           & mask_;
+  }
+  void set(const std::size_t i, const std::uint64_t x) noexcept {
+    const std::size_t bit = i * width_;
+    const std::size_t w = bit / 64;
+    const unsigned offset = bit % 64;
+    words_[w] |= x << offset;
+    words_[w + 1] |= (x >> 1) >> (63 - offset);
+  }
+  unsigned width() const noexcept { return width_; }
+  std::size_t bytes() const noexcept { return words_.size() * 8; }
+
+ private:
+  unsigned width_ = 0;
+  std::uint64_t mask_ = 0;
+  std::vector<std::uint64_t> words_;
+};
+
+/// \brief Compressed column of an integral or enumeration type V
+template <class V, bool = is_packable<V>::value> class frozen_column {
+ public:
+  using value_type = V;
+
+  frozen_column() = default;
+  /// \brief Encodes [first, last) with the encoding that needs the fewest
+  /// bytes
+  template <class It> frozen_column(It first, It last) {
+    std::vector<std::uint64_t> bits;
+    bits.reserve(std::distance(first, last));
+    V min = V(), max = V();
+    bool sorted = true;
+    for (; first != last; ++first) {
+      const V v = *first;
+      if (bits.empty() || v < min) { min = v; }
+      if (bits.empty() || max < v) { max = v; }
+      if (!bits.empty() && v < from_bits<V>(bits.back())) { sorted = false; }
+      bits.push_back(to_bits(v));
+    }
+    size_ = bits.size();
+    base_ = to_bits(min);
+
+    // Size in bits of each candidate encoding:
+    const unsigned for_width = bit_width(to_bits(max) - base_);
+    std::size_t best = size_ * for_width;
+    encoding_ = encoding::frame_of_reference;
+
+    unsigned delta_width = 0;
+    if (sorted) {
+      for (std::size_t i = 1; i < size_; ++i) {
+        if (i % frozen_block_size != 0) {
+          delta_width = std::max(delta_width, bit_width(bits[i] - bits[i - 1]));
+        }
+      }
+      const std::size_t delta_bits
+          = size_ * delta_width + no_blocks() * 64;
+      if (delta_bits < best) {
+        best = delta_bits;
+        encoding_ = encoding::delta;
+      }
+    }
+
+    if (for_width > 8) {
+      std::vector<V> distinct(size_);
+      std::transform(bits.begin(), bits.end(), distinct.begin(),
+                     [](std::uint64_t b) { return from_bits<V>(b); });
+      std::sort(distinct.begin(), distinct.end());
+      distinct.erase(std::unique(distinct.begin(), distinct.end()),
+                     distinct.end());
+      const unsigned dictionary_width = bit_width(distinct.size() - 1);
+      const std::size_t dictionary_bits
+          = size_ * dictionary_width + distinct.size() * 64;
+      if (dictionary_bits < best) {
+        encoding_ = encoding::dictionary;
+        dictionary_.resize(distinct.size());
+        std::transform(distinct.begin(), distinct.end(), dictionary_.begin(),
+                       [](V v) { return to_bits(v); });
+        ints_ = packed_ints(size_, dictionary_width);
+        for (std::size_t i = 0; i != size_; ++i) {
+          const auto it = std::lower_bound(distinct.begin(), distinct.end(),
+                                           from_bits<V>(bits[i]));
+          ints_.set(i, it - distinct.begin());
+        }
+        return;
+      }
+    }
+
+    if (encoding_ == encoding::delta) {
+      ints_ = packed_ints(size_, delta_width);
+      anchors_.resize(no_blocks());
+      for (std::size_t i = 0; i != size_; ++i) {
+        if (i % frozen_block_size == 0) {
+          anchors_[i / frozen_block_size] = bits[i];
+        } else {
+          ints_.set(i, bits[i] - bits[i - 1]);
+        }
+      }
+      return;
+    }
+    ints_ = packed_ints(size_, for_width);
+    for (std::size_t i = 0; i != size_; ++i) { ints_.set(i, bits[i] - base_); }
+  }
+
+  /// \brief Decodes the value of the row i
+  ///
+  /// For the delta encoding this decodes the row's block up to i.
+  [[gnu::hot, gnu::pure]] inline
+  V operator[](const std::size_t i) const noexcept {
+    switch (encoding_) {
+      case encoding::delta: {
+        const std::size_t first = i / frozen_block_size * frozen_block_size;
+        std::uint64_t x = anchors_[i / frozen_block_size];
+        for (std::size_t j = first + 1; j <= i; ++j) { x += ints_[j]; }
+        return from_bits<V>(x);
+      }
+      case encoding::dictionary: return from_bits<V>(dictionary_[ints_[i]]);
+      default: return from_bits<V>(base_ + ints_[i]);
+    }
+  }
+
+  /// \name Sequential decoding
+  ///
+  /// The iterators of a delta-encoded column keep the running sum x of the
+  /// current row, so that moving to the next row adds a single delta.
+  ///@{
+  /// \brief Running sum of the row i (or 0 if the column is not
+  /// delta-encoded, or i is not a row)
+  std::uint64_t prefix(const std::size_t i) const noexcept {
+    if (encoding_ != encoding::delta || i >= size_) { return 0; }
+    return to_bits((*this)[i]);
+  }
+  /// \brief Running sum of the row i, given the running sum x of the row
+  /// i - 1
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  std::uint64_t next_prefix(const std::size_t i,
+                            const std::uint64_t x) const noexcept {
+    if (encoding_ != encoding::delta || i >= size_) { return 0; }
+    return i % frozen_block_size == 0 ? anchors_[i / frozen_block_size]
+                                      : x + ints_[i];
+  }
+  /// \brief Running sum of the row i - 1, given the running sum x of the
+  /// row i
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  std::uint64_t previous_prefix(const std::size_t i,
+                                const std::uint64_t x) const noexcept {
+    if (encoding_ != encoding::delta) { return 0; }
+    return i % frozen_block_size == 0 || i >= size_ ? prefix(i - 1)
+                                                    : x - ints_[i];
+  }
+  /// \brief Value of the row i, whose running sum is x
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  V value(const std::size_t i, const std::uint64_t x) const noexcept {
+    return encoding_ == encoding::delta ? from_bits<V>(x) : (*this)[i];
+  }
+  ///@}
+
+  /// \brief Decodes the n rows [first, first + n) into out (first must be a
+  /// multiple of frozen_block_size)
+  ///
+  /// The loops are branch-free so that they can be vectorized.
+  [[gnu::hot]] void decode(const std::size_t first, const std::size_t n,
+                           V* out) const noexcept {
+    switch (encoding_) {
+      case encoding::delta: {
+        std::uint64_t x = anchors_[first / frozen_block_size];
+        out[0] = from_bits<V>(x);
+        for (std::size_t j = 1; j < n; ++j) {
+          x += ints_[first + j];
+          out[j] = from_bits<V>(x);
+        }
+        return;
+      }
+      case encoding::dictionary: {
+        for (std::size_t j = 0; j != n; ++j) {
+          out[j] = from_bits<V>(dictionary_[ints_[first + j]]);
+        }
+        return;
+      }
+      default: {
+        for (std::size_t j = 0; j != n; ++j) {
+          out[j] = from_bits<V>(base_ + ints_[first + j]);
+        }
+        return;
+      }
+    }
+  }
+
+  std::size_t size() const noexcept { return size_; }
+  scattered::encoding encoding() const noexcept { return encoding_; }
+  /// \brief Number of bits of each packed integer
+  unsigned width() const noexcept { return ints_.width(); }
+  /// \brief Size in bytes of the encoded column
+  std::size_t bytes() const noexcept {
+    return ints_.bytes() + 8 * (anchors_.size() + dictionary_.size());
+  }
+
+ private:
+  scattered::encoding encoding_ = scattered::encoding::frame_of_reference;
+  std::size_t size_ = 0;
+  std::uint64_t base_ = 0;                 ///< Frame of reference
+  packed_ints ints_;                       ///< Encoded rows
+  std::vector<std::uint64_t> anchors_;     ///< Delta: first row of a block
+  std::vector<std::uint64_t> dictionary_;  ///< Dictionary: sorted values
+
+  std::size_t no_blocks() const noexcept {
+    return (size_ + frozen_block_size - 1) / frozen_block_size;
+  }
+};
+
+/// \brief Column of a type that is not compressed
+template <class V> class frozen_column<V, false> {
+ public:
+  using value_type = V;
+
+  frozen_column() = default;
+  template <class It> frozen_column(It first, It last) : values_(first, last) {}
+
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  V const& operator[](const std::size_t i) const noexcept {
+    return values_[i];
+  }
+
+  std::uint64_t prefix(const std::size_t) const noexcept { return 0; }
+  std::uint64_t next_prefix(const std::size_t,
+                            const std::uint64_t) const noexcept {
+    return 0;
+  }
+  std::uint64_t previous_prefix(const std::size_t,
+                                const std::uint64_t) const noexcept {
+    return 0;
+  }
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  V const& value(const std::size_t i, const std::uint64_t) const noexcept {
+    return values_[i];
+  }
+  void decode(const std::size_t first, const std::size_t n, V* out) const {
+    std::copy_n(values_.begin() + first, n, out);
+  }
+
+  std::size_t size() const noexcept { return values_.size(); }
+  scattered::encoding encoding() const noexcept {
+    return scattered::encoding::plain;
+  }
+  unsigned width() const noexcept { return 8 * sizeof(V); }
+  std::size_t bytes() const noexcept { return values_.size() * sizeof(V); }
+
+ private:
+  std::vector<V> values_;
+};
+
+/// \brief Random-access iterator over the decoded rows of a frozen column
+///
+/// Incrementing and decrementing decode the next row from the current one
+/// (a single delta for delta-encoded columns), so that traversing a column
+/// costs O(1) per row. Jumps (+=, -=) decode the target row from its block's
+/// anchor.
+template <class Column>
+class frozen_column_iterator
+    : public boost::iterator_facade
+      <frozen_column_iterator<Column>, typename Column::value_type,
+       std::random_access_iterator_tag,
+       decltype(std::declval<const Column&>().value(0, 0)), std::ptrdiff_t> {
+  using value_reference = decltype(std::declval<const Column&>().value(0, 0));
+
+ public:
+  frozen_column_iterator() = default;
+  frozen_column_iterator(const Column* c, const std::size_t i) noexcept
+      : c_(c),
+        i_(i),
+        x_(c->prefix(i)) {}
+
+ private:
+  friend class boost::iterator_core_access;
+  const Column* c_ = nullptr;
+  std::size_t i_ = 0;
+  std::uint64_t x_ = 0;  ///< Running sum of the row i_ (delta encoding)
+
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  value_reference dereference() const noexcept { return c_->value(i_, x_); }
+  [[gnu::always_inline, gnu::hot]] inline void increment() noexcept {
+    ++i_;
+    x_ = c_->next_prefix(i_, x_);
+  }
+  [[gnu::always_inline, gnu::hot]] inline void decrement() noexcept {
+    x_ = c_->previous_prefix(i_, x_);
+    --i_;
+  }
+  void advance(const std::ptrdiff_t n) noexcept {
+    i_ += n;
+    x_ = c_->prefix(i_);
+  }
+  bool equal(const frozen_column_iterator& other) const noexcept {
+    return i_ == other.i_;
+  }
+  std::ptrdiff_t distance_to(const frozen_column_iterator& other) const
+      noexcept {
+    return static_cast<std::ptrdiff_t>(other.i_)
+           - static_cast<std::ptrdiff_t>(i_);
+  }
+};
+
+/// \brief Read-only storage whose columns are frozen_columns
+template <class Columns> class frozen_storage;
+
+template <class... Cs> class frozen_storage<column_list<Cs...>> {
+ public:
+  using columns = column_list<Cs...>;
+  using size_type = std::size_t;
+
+ private:
+  template <class K> using index = column_index<K, columns>;
+  template <class K> using value_t = column_value_t<K, columns>;
+
+ public:
+  template <class K> using column_type = frozen_column<value_t<K>>;
+  /// \brief Random-access iterator over the decoded rows of the column K
+  template <class K>
+  using const_column_iterator = frozen_column_iterator<column_type<K>>;
+
+  frozen_storage() = default;
+  /// \brief Encodes the columns of the vector v
+  template <class T, class S>
+  explicit frozen_storage(const vector<T, S>& v)
+      : columns_(column_type<typename Cs::key>(
+            v.storage().template begin<typename Cs::key>(),
+            v.storage().template end<typename Cs::key>())...),
+        size_(v.size()) {}
+
+  /// \name Column access
+  ///@{
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  column_type<K> const& column() const noexcept {
+    return std::get<index<K>::value>(columns_);
+  }
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  const_column_iterator<K> begin() const noexcept {
+    return {&column<K>(), 0};
+  }
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  const_column_iterator<K> end() const noexcept {
+    return {&column<K>(), size_};
+  }
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  decltype(auto) at(const size_type i) const noexcept {
+    return column<K>()[i];
+  }
+  ///@}
+
+  size_type size() const noexcept { return size_; }
+
+ private:
+  std::tuple<column_type<typename Cs::key>...> columns_;
+  size_type size_ = 0;
+};
+
+}  // namespace detail
+
+/// \brief Read-only scattered vector whose integral and enumeration columns
+/// are compressed
+///
+/// Each such column is bit-packed with the encoding that needs the fewest
+/// bytes for its data: frame of reference (columns with a small range), delta
+/// (non-decreasing columns) or dictionary (columns with few distinct values).
+/// Other columns are stored uncompressed. Scans should use for_each_block,
+/// which decodes frozen_block_size rows at a time, or the column iterators
+/// (storage().begin<K>()), which decode each row from the previous one. The
+/// row iterators, operator[] and get<K>(v, i) decode a single row (for
+/// delta-encoded columns, the row's block up to the row) and return values
+/// instead of references.
+template <class T> class frozen_vector {
+  using columns = detail::columns_of_t<T>;
+
+ public:
+  using storage_type = detail::frozen_storage<columns>;
+  using size_type = std::size_t;
+  using const_iterator = detail::vector_iterator_base<true, storage_type, T>;
+  using iterator = const_iterator;
+  using value_type = typename const_iterator::value_type;
+  using const_reference = typename const_iterator::reference;
+  using reference = const_reference;
+  using difference_type = typename const_iterator::difference_type;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+  using reverse_iterator = const_reverse_iterator;
+
+  /// \name Constructors
+  ///@{
+  frozen_vector() = default;
+  /// \brief Compresses the columns of v
+  template <class S>
+  explicit frozen_vector(const vector<T, S>& v) : storage_(v) {}
+  ///@}
+
+  /// \name Iterators
+  ///@{
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  const_iterator begin() const noexcept { return {&storage_, 0}; }
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  const_iterator end() const noexcept {
+    return {&storage_, difference_type(size())};
+  }
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  const_iterator cbegin() const noexcept { return begin(); }
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  const_iterator cend() const noexcept { return end(); }
+  const_reverse_iterator rbegin() const noexcept { return cend(); }
+  const_reverse_iterator rend() const noexcept { return cbegin(); }
+  ///@}
+
+  /// \name Element access
+  ///@{
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  const_reference operator[](const size_type pos) const noexcept {
+    return {&storage_, pos};
+  }
+  const_reference at(const size_type pos) const {
+    if (!(pos < size())) {
+      throw std::out_of_range("scattered::frozen_vector::at("
+                              + std::to_string(pos) + ") is out of bounds [0,"
+                              + std::to_string(size()) + ")");
+    }
+    return (*this)[pos];
+  }
+  const_reference front() const noexcept { return (*this)[0]; }
+  const_reference back() const noexcept { return (*this)[size() - 1]; }
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  storage_type const& storage() const noexcept { return storage_; }
+  /// \brief Compressed column of key K
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  decltype(auto) data() const noexcept {
+    return storage_.template column<K>();
+  }
+  ///@}
+
+  /// \name Capacity
+  ///@{
+  bool empty() const noexcept { return size() == 0; }
+  size_type size() const noexcept { return storage_.size(); }
+  /// \brief Size in bytes of all the encoded columns
+  size_type bytes() const noexcept {
+    size_type result = 0;
+    detail::for_each_column(columns{}, [&](auto c) {
+      result += storage_.template column<typename decltype(c)::key>().bytes();
+    });
+    return result;
+  }
+  ///@}
+
+  /// \brief Do v and f store the same rows?
+  ///
+  /// The columns of f are decoded a block at a time.
+  template <class S>
+  inline friend bool operator==(const frozen_vector& f,
+                                const vector<T, S>& v) {
+    return f.size() == v.size()
+           && detail::all_columns(columns{}, [&](auto c) {
+                using key = typename decltype(c)::key;
+                using V = typename decltype(c)::value_type;
+                const auto& column = f.storage_.template column<key>();
+                auto it = v.storage().template begin<key>();
+                V block[detail::frozen_block_size];
+                for (std::size_t i = 0; i < f.size();
+                     i += detail::frozen_block_size) {
+                  const std::size_t n
+                      = std::min(f.size() - i, detail::frozen_block_size);
+                  column.decode(i, n, block);
+                  if (!std::equal(block, block + n, it)) { return false; }
+                  it += n;
+                }
+                return true;
+              });
+  }
+  template <class S>
+  inline friend bool operator==(const vector<T, S>& v,
+                                const frozen_vector& f) {
+    return f == v;
+  }
+
+ private:
+  storage_type storage_;
+};
+
+/// \brief Compresses the vector v into a frozen_vector
+template <class T, class S> frozen_vector<T> freeze(const vector<T, S>& v) {
+  return frozen_vector<T>(v);
+}
+
+/// \brief Element of the column K at row i of the frozen vector v (decoded)
+template <class K, class T>
+[[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+decltype(auto) get(const frozen_vector<T>& v, const std::size_t i) noexcept {
+  return v.storage().template at<K>(i);
+}
+
+/// \brief Decodes the column K of v a block at a time, calling f(values, n)
+/// with n <= frozen_block_size consecutive decoded values of the column
+template <class K, class T, class F>
+void for_each_block(const frozen_vector<T>& v, F&& f) {
+  using value_type = detail::column_value_t<K, detail::columns_of_t<T>>;
+  const auto& column = v.template data<K>();
+  value_type block[detail::frozen_block_size];
+  for (std::size_t i = 0; i < v.size(); i += detail::frozen_block_size) {
+    const std::size_t n = std::min(v.size() - i, detail::frozen_block_size);
+    column.decode(i, n, block);
+    f(static_cast<const value_type*>(block), n);
+  }
+}
+
+}  // namespace scattered
+
+#endif  // SCATTERED_DETAIL_FROZEN_VECTOR_HPP
@@ -8,6 +8,8 @@
 #if !defined(SCATTERED_DETAIL_GET_HPP)
 #define SCATTERED_DETAIL_GET_HPP
 
+#include <type_traits>
+#include <utility>
 #include <boost/fusion/sequence/intrinsic/at_key.hpp>
 #include "returns.hpp"
 #include "unqualified.hpp"
@@ -16,19 +18,22 @@ namespace scattered {
 
 namespace get_detail {
 
-struct is_iterator_test {
-  template <class U>
-  static auto test(U* p) -> decltype(p -> it(), std::true_type());
-  template <class> static auto test(...) -> std::false_type;
+struct has_member_get_test {
+  template <class K, class U>
+  static auto test(U* p)
+      -> decltype(p -> template get<K>(), std::true_type());
+  template <class, class> static auto test(...) -> std::false_type;
 };
 
-template <class T>
-struct is_iterator
-    : decltype(is_iterator_test::test<detail::unqualified_t<T>>(0)) {};
+/// \brief Types with a member get<K>() (scattered iterators and references)
+template <class K, class T>
+struct has_member_get
+    : decltype(has_member_get_test::test<K, detail::unqualified_t<T>>(0)) {};
 
 struct is_adapted_iterator_test {
   template <class U>
-  static auto test(U* p) -> decltype(p -> base(), std::true_type());
+  static auto test(U* p)
+      -> decltype(p -> base(), typename U::iterator_type(), std::true_type());
   template <class> static auto test(...) -> std::false_type;
 };
 
@@ -40,19 +45,17 @@ struct is_adapted_iterator
 
 /// \brief Get element at key
 template <class K, class C,
-          std::enable_if_t<!get_detail::is_iterator<C>::value
+          std::enable_if_t<!get_detail::has_member_get<K, C>::value
                            && !get_detail::is_adapted_iterator<C>::value,
                            int> = 0>
 [[gnu::always_inline, gnu::hot, gnu::const, gnu::flatten]] inline
 auto get(C&& c) RETURNS(boost::fusion::at_key<K>(std::forward<C>(c)));
 
-/// \brief Get element at key for an iterator
+/// \brief Get element at key for a scattered iterator or reference
 template <class K, class C,
-          std::enable_if_t<get_detail::is_iterator<C>::value, int> = 0>
+          std::enable_if_t<get_detail::has_member_get<K, C>::value, int> = 0>
 [[gnu::always_inline, gnu::hot, gnu::const, gnu::flatten]] inline
-auto get(C&& c) noexcept {
-  return get<K>(std::forward<decltype(c.it())>(c.it()));
-}
+auto get(C&& c) RETURNS(c.template get<K>());
 
 /// \brief Get element at key for an adapted iterator
 template <class K, class C,
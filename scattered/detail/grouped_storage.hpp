@@ -0,0 +1,297 @@
+// (C) Copyright Gonzalo Brito Gadeschi 2014
+// Use, modification and distribution are subject to the Boost Software License,
+// Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt).
+
+/// \file \brief Storage that interleaves groups of columns
+
+#if !defined(SCATTERED_DETAIL_GROUPED_STORAGE_HPP)
+#define SCATTERED_DETAIL_GROUPED_STORAGE_HPP
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <boost/iterator/transform_iterator.hpp>
+#include <boost/range/iterator_range.hpp>
+#include "columns.hpp"
+#include "container_storage.hpp"
+
+namespace scattered {
+
+/// \brief Group of keys whose data members are stored interleaved in a
+/// single column (see grouped_storage)
+template <class... Keys> struct group {};
+
+namespace detail {
+
+/// \brief Is K one of the keys of the group G?
+template <class K, class G> struct in_group;
+template <class K, class... Ks>
+struct in_group<K, group<Ks...>>
+    : std::integral_constant
+      <bool, index_of<K, Ks...>() != sizeof...(Ks)> {};
+
+/// \brief Number of groups Gs containing the key K
+template <class K, class... Gs> constexpr std::size_t no_groups_of() noexcept {
+  constexpr bool in[] = {false, in_group<K, Gs>::value...};
+  std::size_t result = 0;
+  for (auto i : in) { result += i ? 1 : 0; }
+  return result;
+}
+
+/// \brief Group of Gs containing the key K (void if K is not grouped)
+template <class K, class... Gs> struct group_of { using type = void; };
+template <class K, class G, class... Gs> struct group_of<K, G, Gs...> {
+  using type = std::conditional_t
+      <in_group<K, G>::value, G, typename group_of<K, Gs...>::type>;
+};
+
+template <class K, class... Gs>
+using group_of_t = typename group_of<K, Gs...>::type;
+
+/// \brief Position of the key K in the group G
+template <class K, class G> struct position_in_group;
+template <class K, class... Ks>
+struct position_in_group<K, group<Ks...>>
+    : std::integral_constant<std::size_t, index_of<K, Ks...>()> {};
+
+/// \brief Element of the column storing the group G: the data members of
+/// the keys of G, in the order of the keys
+template <class G, class Columns> struct group_record;
+template <class... Ks, class Columns>
+struct group_record<group<Ks...>, Columns> {
+  using type = std::tuple<column_value_t<Ks, Columns>...>;
+};
+
+/// \brief Concatenates column lists
+template <class... Ls> struct concat_columns {
+  using type = column_list<>;
+};
+template <class... As> struct concat_columns<column_list<As...>> {
+  using type = column_list<As...>;
+};
+template <class... As, class... Bs, class... Ls>
+struct concat_columns<column_list<As...>, column_list<Bs...>, Ls...> {
+  using type = typename concat_columns<column_list<As..., Bs...>, Ls...>::type;
+};
+
+/// \brief Columns storing the column C of Columns grouped by G: the column
+/// of G replaces the column of its first key, the other keys of G have no
+/// column
+template <class C, class Columns, class G> struct grouped_column {
+  using type = std::conditional_t
+      <position_in_group<typename C::key, G>::value == 0,
+       column_list<column<G, typename group_record<G, Columns>::type>>,
+       column_list<>>;
+};
+template <class C, class Columns> struct grouped_column<C, Columns, void> {
+  using type = column_list<C>;
+};
+
+/// \brief Columns -> columns with each group Gs stored as a single column
+template <class Columns, class... Gs> struct grouped_columns;
+template <class... Cs, class... Gs>
+struct grouped_columns<column_list<Cs...>, Gs...> {
+  using type = typename concat_columns
+      <typename grouped_column
+       <Cs, column_list<Cs...>,
+        group_of_t<typename Cs::key, Gs...>>::type...>::type;
+};
+
+/// \brief Member I of a group record
+template <std::size_t I> struct group_member {
+  template <class Record>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  decltype(auto) operator()(Record&& r) const noexcept {
+    return std::get<I>(r);
+  }
+};
+
+/// \brief Access to the column K of a grouped storage with inner storage S
+///
+/// If K is grouped in G, it accesses the member of K of the column G.
+template <class K, class G> struct grouped_access {
+  using member = group_member<position_in_group<K, G>::value>;
+  template <class S>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] static inline
+  decltype(auto) at(S& s, const std::size_t i) noexcept {
+    return member{}(s.template at<G>(i));
+  }
+  template <class S>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] static inline
+  auto begin(S& s) noexcept {
+    return boost::make_transform_iterator(s.template begin<G>(), member{});
+  }
+  template <class S>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] static inline
+  auto end(S& s) noexcept {
+    return boost::make_transform_iterator(s.template end<G>(), member{});
+  }
+};
+template <class K> struct grouped_access<K, void> {
+  template <class S>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] static inline
+  decltype(auto) at(S& s, const std::size_t i) noexcept {
+    return s.template at<K>(i);
+  }
+  template <class S>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] static inline
+  auto begin(S& s) noexcept {
+    return s.template begin<K>();
+  }
+  template <class S>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] static inline
+  auto end(S& s) noexcept {
+    return s.template end<K>();
+  }
+};
+
+/// \brief Stores the columns of each group Gs interleaved in a single column
+/// of the inner Storage policy, and the other columns as Storage does
+///
+/// Its interface is that of the columns of T: column K of a group is
+/// accessed through the member of K of the group column.
+template <class Columns, class Storage, class... Gs> class grouped_storage;
+
+template <class... Cs, class Storage, class... Gs>
+class grouped_storage<column_list<Cs...>, Storage, Gs...> {
+ public:
+  using columns = column_list<Cs...>;
+  /// Columns of the inner storage
+  using inner_columns = typename grouped_columns<columns, Gs...>::type;
+  using inner_type = typename Storage::template storage_type<inner_columns>;
+  using size_type = std::size_t;
+  template <class U>
+  using column_type = typename inner_type::template column_type<U>;
+
+ private:
+  template <class K> using access = grouped_access<K, group_of_t<K, Gs...>>;
+
+  static constexpr bool each_key_in_one_group_at_most() noexcept {
+    constexpr std::size_t counts[] = {0, no_groups_of<typename Cs::key,
+                                                      Gs...>()...};
+    for (auto c : counts) {
+      if (c > 1) { return false; }
+    }
+    return true;
+  }
+  static_assert(each_key_in_one_group_at_most(),
+                "a key cannot belong to more than one group");
+
+ public:
+  /// \name Column access
+  ///@{
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  inner_type& inner() noexcept { return inner_; }
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  inner_type const& inner() const noexcept { return inner_; }
+
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  auto begin() noexcept { return access<K>::begin(inner_); }
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  auto begin() const noexcept { return access<K>::begin(inner_); }
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  auto end() noexcept { return access<K>::end(inner_); }
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  auto end() const noexcept { return access<K>::end(inner_); }
+
+  /// \brief Range of the elements of the column K
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  auto column() noexcept {
+    return boost::make_iterator_range(begin<K>(), end<K>());
+  }
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  auto column() const noexcept {
+    return boost::make_iterator_range(begin<K>(), end<K>());
+  }
+
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  decltype(auto) at(const size_type i) noexcept {
+    return access<K>::at(inner_, i);
+  }
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  decltype(auto) at(const size_type i) const noexcept {
+    return access<K>::at(inner_, i);
+  }
+  ///@}
+
+  /// \name Capacity
+  ///@{
+  size_type size() const noexcept { return inner_.size(); }
+  size_type capacity() const noexcept { return inner_.capacity(); }
+  size_type max_size() const noexcept { return inner_.max_size(); }
+  void reserve(const size_type n) { inner_.reserve(n); }
+  void shrink_to_fit() { inner_.shrink_to_fit(); }
+  ///@}
+
+  /// \name Modifiers
+  ///@{
+  void clear() noexcept { inner_.clear(); }
+  void resize(const size_type n) { inner_.resize(n); }
+  /// \brief Inserts n value-initialized rows before the row pos
+  void insert(const size_type pos, const size_type n) { inner_.insert(pos, n); }
+  /// \brief Erases the rows [pos, pos + n)
+  void erase(const size_type pos, const size_type n) { inner_.erase(pos, n); }
+  /// \brief Appends a row whose column C is constructed from f(C{})
+  template <class F> void emplace_back(F&& f) {
+    inner_.emplace_back([&](auto c) -> decltype(auto) {
+      return this->make_element(f, c);
+    });
+  }
+  void pop_back() { inner_.pop_back(); }
+  inline friend void swap(grouped_storage& a, grouped_storage& b) noexcept(
+      noexcept(swap(std::declval<inner_type&>(),
+                    std::declval<inner_type&>()))) {
+    using std::swap;
+    swap(a.inner_, b.inner_);
+  }
+  ///@}
+
+ private:
+  inner_type inner_;
+
+  /// \brief Element of a column that is not a group
+  template <class F, class K, class V>
+  static decltype(auto) make_element(F& f, detail::column<K, V> c) {
+    return f(c);
+  }
+  /// \brief Element of the column of the group group<Ks...>: a record
+  /// constructed from the elements of its keys
+  template <class F, class... Ks, class V>
+  static V make_element(F& f, detail::column<group<Ks...>, V>) {
+    return V(f(detail::column<Ks, column_value_t<Ks, columns>>{})...);
+  }
+};
+
+}  // namespace detail
+
+/// \brief Storage policy: the data members of each group of keys Groups are
+/// stored interleaved in a single column of Storage, the other data members
+/// are stored as Storage does
+///
+/// For example, with
+/// scattered::vector<T, grouped_storage<container_storage<>,
+///                                      group<k::x, k::y, k::z>>>
+/// the members x, y, and z are stored as an array of (x, y, z) records.
+/// Accessing the members with get<K> does not change.
+template <class Storage, class... Groups> struct grouped_storage {
+  template <class Columns>
+  using storage_type = detail::grouped_storage<Columns, Storage, Groups...>;
+};
+
+/// \brief Groups Groups with the default storage (see grouped_storage)
+template <class... Groups>
+using grouped = grouped_storage<container_storage<>, Groups...>;
+
+}  // namespace scattered
+
+#endif  // SCATTERED_DETAIL_GROUPED_STORAGE_HPP
@@ -0,0 +1,167 @@
+// (C) Copyright Gonzalo Brito Gadeschi 2014
+// Use, modification and distribution are subject to the Boost Software License,
+// Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt).
+
+/// \file \brief Allocator backed by huge pages
+
+#if !defined(SCATTERED_DETAIL_HUGE_PAGE_ALLOCATOR_HPP)
+#define SCATTERED_DETAIL_HUGE_PAGE_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace scattered {
+
+/// \brief How huge_page_allocator obtains huge pages
+enum class huge_pages {
+  /// Transparent huge pages: the mapping is aligned to the huge page size and
+  /// marked with madvise(MADV_HUGEPAGE)
+  madvise,
+  /// Explicit huge pages from the hugetlbfs pool (mmap with MAP_HUGETLB).
+  /// Falls back to madvise if the pool has no free pages.
+  hugetlb
+};
+
+namespace detail {
+
+/// Size in bytes of a huge page (x86-64 and AArch64 default)
+static const constexpr std::size_t huge_page_size = std::size_t(2) << 20;
+/// Size in bytes of a base page
+static const constexpr std::size_t base_page_size = 4096;
+
+[[gnu::always_inline, gnu::const]] inline
+constexpr std::size_t round_up_to_huge_pages(const std::size_t n) noexcept {
+  return (n + huge_page_size - 1) / huge_page_size * huge_page_size;
+}
+
+#if defined(__linux__)
+/// \brief Maps bytes (a multiple of huge_page_size) of anonymous memory
+/// backed by huge pages, or returns nullptr
+inline void* map_huge_pages(const std::size_t bytes, const huge_pages pages,
+                            const bool prefault) noexcept {
+  const int prot = PROT_READ | PROT_WRITE;
+  const int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#if defined(MAP_HUGETLB)
+  if (pages == huge_pages::hugetlb) {
+    void* p = ::mmap(nullptr, bytes, prot,
+                     flags | MAP_HUGETLB | (prefault ? MAP_POPULATE : 0), -1,
+                     0);
+    if (p != MAP_FAILED) { return p; }
+  }
+#endif
+  // Map one extra huge page to align the mapping, and unmap the excess:
+  void* raw = ::mmap(nullptr, bytes + huge_page_size, prot, flags, -1, 0);
+  if (raw == MAP_FAILED) { return nullptr; }
+  const auto first = reinterpret_cast<std::uintptr_t>(raw);
+  const auto aligned = (first + huge_page_size - 1) / huge_page_size
+                       * huge_page_size;
+  const auto head = aligned - first;
+  if (head != 0) { ::munmap(raw, head); }
+  ::munmap(reinterpret_cast<void*>(aligned + bytes), huge_page_size - head);
+  void* p = reinterpret_cast<void*>(aligned);
+#if defined(MADV_HUGEPAGE)
+  ::madvise(p, bytes, MADV_HUGEPAGE);
+#endif
+  if (prefault) {
+    // Touch every page (MAP_POPULATE would fault base pages before madvise):
+    auto bytes_ptr = static_cast<volatile char*>(p);
+    for (std::size_t i = 0; i < bytes; i += base_page_size) {
+      bytes_ptr[i] = 0;
+    }
+  }
+  return p;
+}
+#endif
+
+}  // namespace detail
+
+/// \brief Allocator whose large allocations are backed by huge pages
+///
+/// Allocations of at least one huge page (2 MiB) are mapped with mmap,
+/// rounded up to whole huge pages, and requested as specified by Pages. A
+/// column of a large vector then needs one TLB entry per 2 MiB instead of
+/// one per 4 KiB. If Prefault is true, the pages are faulted in when they
+/// are allocated instead of on first touch. Smaller allocations use
+/// ::operator new. On systems without mmap all allocations use ::operator
+/// new.
+template <class T, huge_pages Pages = huge_pages::madvise,
+          bool Prefault = false>
+struct huge_page_allocator {
+  using value_type = T;
+  using pointer = T*;
+  using const_pointer = T const*;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using propagate_on_container_move_assignment = std::true_type;
+  using is_always_equal = std::true_type;
+  template <class U> struct rebind {
+    using other = huge_page_allocator<U, Pages, Prefault>;
+  };
+
+  static const constexpr huge_pages pages = Pages;
+  static const constexpr bool prefault = Prefault;
+
+  huge_page_allocator() noexcept = default;
+  template <class U>
+  huge_page_allocator(const huge_page_allocator<U, Pages, Prefault>&) noexcept {
+  }
+
+  /// \brief Is an allocation of n elements mapped with huge pages?
+  static constexpr bool is_huge(const size_type n) noexcept {
+#if defined(__linux__)
+    return n * sizeof(T) >= detail::huge_page_size;
+#else
+    return false;
+#endif
+  }
+
+  T* allocate(const size_type n) {
+    if (n > max_size()) { throw std::bad_alloc(); }
+    void* p = nullptr;
+#if defined(__linux__)
+    if (is_huge(n)) {
+      p = detail::map_huge_pages(
+          detail::round_up_to_huge_pages(n * sizeof(T)), Pages, Prefault);
+      if (!p) { throw std::bad_alloc(); }
+      return static_cast<T*>(p);
+    }
+#endif
+    p = ::operator new(n * sizeof(T));
+    return static_cast<T*>(p);
+  }
+  void deallocate(T* p, const size_type n) noexcept {
+    if (!p) { return; }
+#if defined(__linux__)
+    if (is_huge(n)) {
+      ::munmap(p, detail::round_up_to_huge_pages(n * sizeof(T)));
+      return;
+    }
+#endif
+    ::operator delete(p);
+  }
+
+  size_type max_size() const noexcept {
+    return (std::numeric_limits<size_type>::max() - detail::huge_page_size)
+           / sizeof(T);
+  }
+
+  friend bool operator==(const huge_page_allocator&,
+                         const huge_page_allocator&) noexcept {
+    return true;
+  }
+  friend bool operator!=(const huge_page_allocator&,
+                         const huge_page_allocator&) noexcept {
+    return false;
+  }
+};
+
+}  // namespace scattered
+
+#endif  // SCATTERED_DETAIL_HUGE_PAGE_ALLOCATOR_HPP
@@ -0,0 +1,141 @@
+// (C) Copyright Gonzalo Brito Gadeschi 2014
+// Use, modification and distribution are subject to the Boost Software License,
+// Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt).
+
+/// \file \brief Run-time selection of the instruction set of the column
+/// kernels
+///
+/// The vectorizable kernels (transform, reduce, mask) are compiled once per
+/// instruction set, and the variant for the best instruction set supported
+/// by the CPU is called. The instruction set is selected once, on first use,
+/// so that a binary compiled for the baseline architecture uses e.g. AVX2 on
+/// the machines that have it.
+///
+/// The environment variable SCATTERED_ISA (generic, sse4.2, avx2, or avx512)
+/// overrides the selection, e.g. to benchmark each variant. Instruction sets
+/// that the CPU does not support are never selected.
+
+#if !defined(SCATTERED_DETAIL_ISA_HPP)
+#define SCATTERED_DETAIL_ISA_HPP
+
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SCATTERED_ISA_DISPATCH 1
+#endif
+
+namespace scattered {
+
+/// \brief Instruction sets of the column kernels (in increasing order)
+enum class isa { generic, sse4_2, avx2, avx512 };
+
+inline const char* name(const isa i) noexcept {
+  switch (i) {
+    case isa::sse4_2: return "sse4.2";
+    case isa::avx2: return "avx2";
+    case isa::avx512: return "avx512";
+    default: return "generic";
+  }
+}
+
+namespace detail {
+
+/// \brief Best instruction set supported by the CPU
+inline isa supported_isa() noexcept {
+#if defined(SCATTERED_ISA_DISPATCH)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")
+      && __builtin_cpu_supports("avx512dq")
+      && __builtin_cpu_supports("avx512vl")) {
+    return isa::avx512;
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return isa::avx2;
+  }
+  if (__builtin_cpu_supports("sse4.2")) { return isa::sse4_2; }
+#endif
+  return isa::generic;
+}
+
+/// \brief Instruction set named s, or fallback if s names none
+inline isa parse_isa(const char* s, const isa fallback) noexcept {
+  if (s == nullptr) { return fallback; }
+  for (isa i : {isa::generic, isa::sse4_2, isa::avx2, isa::avx512}) {
+    if (std::strcmp(s, name(i)) == 0) { return i; }
+  }
+  return fallback;
+}
+
+}  // namespace detail
+
+/// \brief Instruction set of the column kernels: the best one supported by
+/// the CPU, or the one of the environment variable SCATTERED_ISA if the CPU
+/// supports it
+inline isa selected_isa() noexcept {
+  static const isa selected = []() {
+    const isa supported = detail::supported_isa();
+    const isa requested
+        = detail::parse_isa(std::getenv("SCATTERED_ISA"), supported);
+    return requested < supported ? requested : supported;
+  }();
+  return selected;
+}
+
+}  // namespace scattered
+
+/// \brief Defines the struct name, whose static member function
+/// name::call(args...) calls body(args...) compiled for selected_isa()
+///
+/// The body is inlined into one function per instruction set, each compiled
+/// with the corresponding target attribute, so body should be always_inline
+/// and its loops are vectorized for every instruction set (the functions it
+/// calls, e.g. a user lambda, are inlined into it as usual).
+#if defined(SCATTERED_ISA_DISPATCH)
+#define SCATTERED_MULTIVERSIONED(name, body)                                  \
+  struct name {                                                               \
+    template <class... Args>                                                  \
+    [[gnu::target("avx512f,avx512bw,avx512dq,avx512vl,avx2,fma")]]            \
+    static decltype(auto) avx512(Args&&... args) {                            \
+      return body(std::forward<Args>(args)...);                               \
+    }                                                                         \
+    template <class... Args>                                                  \
+    [[gnu::target("avx2,fma")]]                                               \
+    static decltype(auto) avx2(Args&&... args) {                              \
+      return body(std::forward<Args>(args)...);                               \
+    }                                                                         \
+    template <class... Args>                                                  \
+    [[gnu::target("sse4.2")]]                                                 \
+    static decltype(auto) sse4_2(Args&&... args) {                            \
+      return body(std::forward<Args>(args)...);                               \
+    }                                                                         \
+    template <class... Args>                                                  \
+    static decltype(auto) generic(Args&&... args) {                           \
+      return body(std::forward<Args>(args)...);                               \
+    }                                                                         \
+    template <class... Args>                                                  \
+    static decltype(auto) call(Args&&... args) {                              \
+      switch (::scattered::selected_isa()) {                                  \
+        case ::scattered::isa::avx512:                                        \
+          return avx512(std::forward<Args>(args)...);                         \
+        case ::scattered::isa::avx2:                                          \
+          return avx2(std::forward<Args>(args)...);                           \
+        case ::scattered::isa::sse4_2:                                        \
+          return sse4_2(std::forward<Args>(args)...);                         \
+        default: return generic(std::forward<Args>(args)...);                 \
+      }                                                                       \
+    }                                                                         \
+  }
+#else
+#define SCATTERED_MULTIVERSIONED(name, body)                                  \
+  struct name {                                                               \
+    template <class... Args>                                                  \
+    static decltype(auto) call(Args&&... args) {                              \
+      return body(std::forward<Args>(args)...);                               \
+    }                                                                         \
+  }
+#endif
+
+#endif  // SCATTERED_DETAIL_ISA_HPP
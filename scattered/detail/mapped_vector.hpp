@@ -0,0 +1,583 @@
+// (C) Copyright Gonzalo Brito Gadeschi 2014
+// Use, modification and distribution are subject to the Boost Software License,
+// Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt).
+
+/// \file \brief Columnar file format and read-only memory-mapped vector
+///
+/// A file stores the columns of a vector of n rows as follows (all integers
+/// are unsigned and stored in the byte order of the writer, which is checked
+/// when the file is opened):
+///
+///  - file_header (32 bytes): magic "SCATTERD", format version, byte order
+///    mark, number of columns, number of rows n and alignment of the columns,
+///  - one column_header (64 bytes) per column, in declaration order: member
+///    name, kind and size of the value type, and offset and size in bytes of
+///    the column data,
+///  - the data of each column, contiguous and aligned to file_alignment
+///    bytes: n values, or for bool columns n bits packed in 64-bit words (as
+///    in bit_vector).
+///
+/// Since the columns are aligned to the page size, they can be used directly
+/// from a read-only mapping of the file.
+
+#if !defined(SCATTERED_DETAIL_MAPPED_VECTOR_HPP)
+#define SCATTERED_DETAIL_MAPPED_VECTOR_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <boost/fusion/adapted/struct/detail/extension.hpp>
+#include <boost/range/iterator_range.hpp>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#error "scattered::mapped_vector requires mmap"
+#endif
+#include "bit_vector.hpp"
+#include "columns.hpp"
+#include "vector.hpp"
+
+namespace scattered {
+
+namespace detail {
+
+/// \name File format
+///@{
+static const constexpr char file_magic[8]
+    = {'S', 'C', 'A', 'T', 'T', 'E', 'R', 'D'};
+static const constexpr std::uint32_t file_version = 1;
+static const constexpr std::uint32_t file_byte_order = 0x01020304;
+/// Alignment in bytes of the column data in a file
+static const constexpr std::uint64_t file_alignment = 4096;
+/// Maximum length of a member name (the name is null-terminated)
+static const constexpr std::size_t file_max_name = 39;
+
+struct file_header {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byte_order;
+  std::uint32_t no_columns;
+  std::uint32_t alignment;
+  std::uint64_t no_rows;
+};
+
+/// \brief How the values of a column are stored
+enum class column_kind : std::uint32_t {
+  packed_bool = 1,  ///< Bits packed in 64-bit words
+  floating_point = 2,
+  signed_integer = 3,
+  unsigned_integer = 4,
+  bytes = 5  ///< Any other trivially copyable type
+};
+
+struct column_header {
+  char name[file_max_name + 1];
+  std::uint32_t kind;
+  std::uint32_t value_size;
+  std::uint64_t offset;
+  std::uint64_t bytes;
+};
+
+static_assert(sizeof(file_header) == 32, "unexpected file_header padding");
+static_assert(sizeof(column_header) == 64, "unexpected column_header padding");
+///@}
+
+template <class V> constexpr column_kind kind_of() noexcept {
+  return std::is_same<V, bool>::value
+             ? column_kind::packed_bool
+             : std::is_floating_point<V>::value
+                   ? column_kind::floating_point
+                   : std::is_integral<V>::value
+                         ? (std::is_signed<V>::value
+                                ? column_kind::signed_integer
+                                : column_kind::unsigned_integer)
+                         : column_kind::bytes;
+}
+
+/// \brief Size in bytes of the data of a column of n values of type V
+template <class V> constexpr std::uint64_t column_bytes(const std::uint64_t n) {
+  return std::is_same<V, bool>::value ? no_words(n) * sizeof(bit_word)
+                                      : n * sizeof(V);
+}
+
+[[gnu::always_inline, gnu::const]] inline
+constexpr std::uint64_t align_to_file(const std::uint64_t n) noexcept {
+  return (n + file_alignment - 1) / file_alignment * file_alignment;
+}
+
+/// \brief Name of the I-th member of the adapted struct T
+template <class T, std::size_t I> inline const char* member_name() noexcept {
+  return boost::fusion::extension::struct_member_name<T, I>::call();
+}
+
+/// \brief Schema of the columns of T: the column headers of a file of n rows
+template <class T, std::size_t... Is>
+std::array<column_header, sizeof...(Is)> make_column_headers(
+    const std::uint64_t n, std::index_sequence<Is...>) {
+  using columns = columns_of_t<T>;
+  std::array<column_header, sizeof...(Is)> headers{};
+  const char* names[] = {member_name<T, Is>()...};
+  std::uint64_t offset = align_to_file(
+      sizeof(file_header) + sizeof...(Is) * sizeof(column_header));
+  for_each_column(columns{}, [&](auto c) {
+    using V = typename decltype(c)::value_type;
+    static_assert(std::is_trivially_copyable<V>::value,
+                  "only trivially copyable members can be stored in a file");
+    constexpr std::size_t i = column_index<typename decltype(c)::key,
+                                           columns>::value;
+    const char* name = names[i];
+    if (std::strlen(name) > file_max_name) {
+      throw std::length_error(std::string("scattered: the member name ")
+                              + name + " is too long for the file format");
+    }
+    auto& h = headers[i];
+    std::strncpy(h.name, name, file_max_name);
+    h.kind = static_cast<std::uint32_t>(kind_of<V>());
+    h.value_size = sizeof(V);
+    h.offset = offset;
+    h.bytes = column_bytes<V>(n);
+    offset = align_to_file(offset + h.bytes);
+  });
+  return headers;
+}
+
+template <class T>
+std::array<column_header, columns_of_t<T>::size> column_headers(
+    const std::uint64_t n) {
+  return make_column_headers<T>(
+      n, std::make_index_sequence<columns_of_t<T>::size>{});
+}
+
+/// \brief Writes the values [first, last) of a column to out (bool columns
+/// are packed in words)
+template <class It>
+void write_column(std::ostream& out, It first, const It last, std::true_type) {
+  std::vector<bit_word> words;
+  words.reserve(1024);
+  while (first != last) {
+    words.clear();
+    for (std::size_t w = 0; w != 1024 && first != last; ++w) {
+      bit_word word = 0;
+      for (std::size_t b = 0; b != bits_per_word && first != last;
+           ++b, ++first) {
+        word |= bit_word(bool(*first)) << b;
+      }
+      words.push_back(word);
+    }
+    out.write(reinterpret_cast<const char*>(words.data()),
+              words.size() * sizeof(bit_word));
+  }
+}
+template <class It>
+void write_column(std::ostream& out, It first, const It last, std::false_type) {
+  using V = typename std::iterator_traits<It>::value_type;
+  std::vector<V> buffer;
+  buffer.reserve(4096);
+  while (first != last) {
+    buffer.clear();
+    for (; buffer.size() != 4096 && first != last; ++first) {
+      buffer.push_back(*first);
+    }
+    out.write(reinterpret_cast<const char*>(buffer.data()),
+              buffer.size() * sizeof(V));
+  }
+}
+
+/// \brief Read-only mapping of a file
+class file_mapping {
+ public:
+  file_mapping() noexcept = default;
+  explicit file_mapping(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw std::runtime_error("scattered: cannot open " + path);
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+      ::close(fd);
+      throw std::runtime_error("scattered: cannot stat " + path);
+    }
+    size_ = st.st_size;
+    if (size_ != 0) {
+      void* p = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+      if (p == MAP_FAILED) {
+        ::close(fd);
+        throw std::runtime_error("scattered: cannot map " + path);
+      }
+      data_ = static_cast<const char*>(p);
+    }
+    ::close(fd);
+  }
+  file_mapping(const file_mapping&) = delete;
+  file_mapping& operator=(const file_mapping&) = delete;
+  file_mapping(file_mapping&& other) noexcept : data_(other.data_),
+                                                size_(other.size_) {
+    other.data_ = nullptr;
+    other.size_ = 0;
+  }
+  file_mapping& operator=(file_mapping&& other) noexcept {
+    if (this != &other) {
+      unmap();
+      data_ = other.data_;
+      size_ = other.size_;
+      other.data_ = nullptr;
+      other.size_ = 0;
+    }
+    return *this;
+  }
+  ~file_mapping() { unmap(); }
+
+  const char* data() const noexcept { return data_; }
+  std::size_t size() const noexcept { return size_; }
+
+  /// \brief Starts reading the pages of [first, first + bytes) into the page
+  /// cache without waiting for them
+  void prefetch(const char* first, const std::size_t bytes) const noexcept {
+#if defined(MADV_WILLNEED)
+    if (bytes == 0) { return; }
+    const std::size_t page = ::sysconf(_SC_PAGESIZE);
+    const std::size_t offset = (first - data_) / page * page;
+    ::madvise(const_cast<char*>(data_) + offset, first + bytes - data_ - offset,
+              MADV_WILLNEED);
+#endif
+  }
+
+ private:
+  const char* data_ = nullptr;
+  std::size_t size_ = 0;
+
+  void unmap() noexcept {
+    if (data_) { ::munmap(const_cast<char*>(data_), size_); }
+  }
+};
+
+/// \brief Checks that the mapped file stores the columns of T and returns
+/// its number of rows
+template <class T>
+std::uint64_t check_schema(const file_mapping& file, const std::string& path) {
+  auto error = [&](const std::string& what) {
+    return std::runtime_error("scattered: " + path + ": " + what);
+  };
+  constexpr std::size_t no_columns = columns_of_t<T>::size;
+  const std::size_t header_bytes
+      = sizeof(file_header) + no_columns * sizeof(column_header);
+  if (file.size() < sizeof(file_header)) {
+    throw error("not a scattered file");
+  }
+  file_header h;
+  std::memcpy(&h, file.data(), sizeof(h));
+  if (std::memcmp(h.magic, file_magic, sizeof(file_magic)) != 0) {
+    throw error("not a scattered file");
+  }
+  if (h.byte_order != file_byte_order) { throw error("wrong byte order"); }
+  if (h.version != file_version) {
+    throw error("unsupported version " + std::to_string(h.version));
+  }
+  if (h.no_columns != no_columns || file.size() < header_bytes) {
+    throw error("wrong number of columns");
+  }
+  const auto expected = column_headers<T>(h.no_rows);
+  for (std::size_t i = 0; i != no_columns; ++i) {
+    column_header c;
+    std::memcpy(&c, file.data() + sizeof(file_header) + i * sizeof(c),
+                sizeof(c));
+    const auto& e = expected[i];
+    if (std::strncmp(c.name, e.name, sizeof(c.name)) != 0
+        || c.kind != e.kind || c.value_size != e.value_size
+        || c.bytes != e.bytes) {
+      throw error(std::string("column ") + e.name + " does not match");
+    }
+    if (c.offset % file_alignment != 0
+        || (c.bytes != 0 && (c.offset > file.size()
+                             || c.bytes > file.size() - c.offset))) {
+      throw error(std::string("column ") + e.name + " is out of bounds");
+    }
+  }
+  return h.no_rows;
+}
+
+/// \brief Data of the column i of the mapped file (nullptr if empty)
+inline const char* column_data(const file_mapping& file,
+                               const std::size_t i) noexcept {
+  column_header c;
+  std::memcpy(&c, file.data() + sizeof(file_header) + i * sizeof(c),
+              sizeof(c));
+  return c.bytes != 0 ? file.data() + c.offset : nullptr;
+}
+
+/// \brief Read-only storage whose columns are sections of a mapped file
+template <class Columns> class mapped_storage;
+
+template <class... Cs> class mapped_storage<column_list<Cs...>> {
+ public:
+  using columns = column_list<Cs...>;
+  using size_type = std::size_t;
+
+ private:
+  template <class K> using index = column_index<K, columns>;
+  template <class K> using value_t = column_value_t<K, columns>;
+  template <class K>
+  using is_bool = std::is_same<value_t<K>, bool>;
+
+ public:
+  /// \brief Iterator over the column K
+  template <class K>
+  using const_column_iterator = std::conditional_t
+      <is_bool<K>::value, bit_iterator<true>, value_t<K> const*>;
+
+  mapped_storage() noexcept = default;
+  /// \brief Maps the file at path, whose schema must be that of T
+  template <class T>
+  mapped_storage(const std::string& path, T*)
+      : file_(path), size_(check_schema<T>(file_, path)) {
+    for_each_column(columns{}, [&](auto c) {
+      using K = typename decltype(c)::key;
+      data_[index<K>::value] = column_data(file_, index<K>::value);
+    });
+  }
+
+  /// \name Column access
+  ///@{
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  boost::iterator_range<const_column_iterator<K>> column() const noexcept {
+    return {begin<K>(), end<K>()};
+  }
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  const_column_iterator<K> begin() const noexcept {
+    return make_begin<K>(is_bool<K>{});
+  }
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  const_column_iterator<K> end() const noexcept {
+    return begin<K>() + size_;
+  }
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  decltype(auto) at(const size_type i) const noexcept {
+    return begin<K>()[i];
+  }
+  ///@}
+
+  size_type size() const noexcept { return size_; }
+
+  /// \brief Starts reading the column K into memory
+  template <class K> void prefetch() const noexcept {
+    file_.prefetch(data_[index<K>::value], column_bytes<value_t<K>>(size_));
+  }
+
+ private:
+  file_mapping file_;
+  size_type size_ = 0;
+  std::array<const char*, sizeof...(Cs)> data_{};
+
+  template <class K>
+  const_column_iterator<K> make_begin(std::true_type) const noexcept {
+    return {reinterpret_cast<const bit_word*>(data_[index<K>::value]), 0};
+  }
+  template <class K>
+  const_column_iterator<K> make_begin(std::false_type) const noexcept {
+    return reinterpret_cast<value_t<K> const*>(data_[index<K>::value]);
+  }
+};
+
+}  // namespace detail
+
+/// \brief Writes the vector v to the file at path in the columnar file
+/// format (see mapped_vector)
+///
+/// The file is written to path + ".tmp" and then renamed, so that readers
+/// never map a partially written file. All the members of T must be
+/// trivially copyable.
+template <class T, class S>
+void save(const vector<T, S>& v, const std::string& path) {
+  using columns = detail::columns_of_t<T>;
+  const std::string tmp = path + ".tmp";
+  const std::uint64_t n = v.size();
+  const auto headers = detail::column_headers<T>(n);
+  {
+    std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+    if (!out) { throw std::runtime_error("scattered: cannot create " + tmp); }
+    detail::file_header h{};
+    std::memcpy(h.magic, detail::file_magic, sizeof(h.magic));
+    h.version = detail::file_version;
+    h.byte_order = detail::file_byte_order;
+    h.no_columns = columns::size;
+    h.alignment = detail::file_alignment;
+    h.no_rows = n;
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    out.write(reinterpret_cast<const char*>(headers.data()),
+              headers.size() * sizeof(detail::column_header));
+    detail::for_each_column(columns{}, [&](auto c) {
+      using K = typename decltype(c)::key;
+      using V = typename decltype(c)::value_type;
+      const auto& header = headers[detail::column_index<K, columns>::value];
+      const std::uint64_t position = out.tellp();
+      const std::vector<char> padding(header.offset - position, 0);
+      out.write(padding.data(), padding.size());
+      detail::write_column(out, v.storage().template begin<K>(),
+                           v.storage().template end<K>(),
+                           std::is_same<V, bool>{});
+    });
+    out.flush();
+    if (!out) { throw std::runtime_error("scattered: cannot write " + tmp); }
+  }
+  if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+    std::remove(tmp.c_str());
+    throw std::runtime_error("scattered: cannot write " + path);
+  }
+}
+
+/// \brief Read-only scattered vector backed by a memory-mapped file written
+/// by save
+///
+/// Opening a file only maps it and checks its schema against T (member
+/// names, kinds and sizes of the members): the columns are used in place,
+/// without deserialization, and the pages are read from the page cache on
+/// first access and shared by all the processes that map the file. The file
+/// must not be modified while it is mapped.
+///
+/// It provides the const interface of scattered::vector: iterators, operator[]
+/// and get<K>(v, i) (bool columns are packed, see bit_vector).
+template <class T> class mapped_vector {
+  using columns = detail::columns_of_t<T>;
+
+ public:
+  using storage_type = detail::mapped_storage<columns>;
+  using size_type = std::size_t;
+  using const_iterator = detail::vector_iterator_base<true, storage_type, T>;
+  using iterator = const_iterator;
+  using value_type = typename const_iterator::value_type;
+  using const_reference = typename const_iterator::reference;
+  using reference = const_reference;
+  using difference_type = typename const_iterator::difference_type;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+  using reverse_iterator = const_reverse_iterator;
+
+  /// \name Constructors
+  ///@{
+  mapped_vector() noexcept = default;
+  /// \brief Maps the file at path
+  ///
+  /// Throws std::runtime_error if the file cannot be mapped or does not store
+  /// a vector of T.
+  explicit mapped_vector(const std::string& path)
+      : storage_(path, static_cast<T*>(nullptr)) {}
+  mapped_vector(mapped_vector&&) = default;
+  mapped_vector& operator=(mapped_vector&&) = default;
+  ///@}
+
+  /// \name Iterators
+  ///@{
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  const_iterator begin() const noexcept { return {&storage_, 0}; }
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  const_iterator end() const noexcept {
+    return {&storage_, difference_type(size())};
+  }
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  const_iterator cbegin() const noexcept { return begin(); }
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  const_iterator cend() const noexcept { return end(); }
+  const_reverse_iterator rbegin() const noexcept { return cend(); }
+  const_reverse_iterator rend() const noexcept { return cbegin(); }
+  ///@}
+
+  /// \name Element access
+  ///@{
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  const_reference operator[](const size_type pos) const noexcept {
+    return {&storage_, pos};
+  }
+  const_reference at(const size_type pos) const {
+    if (!(pos < size())) {
+      throw std::out_of_range("scattered::mapped_vector::at("
+                              + std::to_string(pos) + ") is out of bounds [0,"
+                              + std::to_string(size()) + ")");
+    }
+    return (*this)[pos];
+  }
+  const_reference front() const noexcept { return (*this)[0]; }
+  const_reference back() const noexcept { return (*this)[size() - 1]; }
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  storage_type const& storage() const noexcept { return storage_; }
+  /// \brief Column of key K
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  decltype(auto) data() const { return storage_.template column<K>(); }
+  ///@}
+
+  /// \name Capacity
+  ///@{
+  bool empty() const noexcept { return size() == 0; }
+  size_type size() const noexcept { return storage_.size(); }
+  ///@}
+
+  /// \brief Starts reading the columns Ks into memory
+  ///
+  /// The other columns are read on demand, when their pages are first
+  /// accessed.
+  template <class... Ks> void prefetch() const noexcept {
+    int dummy[] = {0, (storage_.template prefetch<Ks>(), 0)...};
+    (void)dummy;
+  }
+
+  /// \brief Do v and m store the same rows?
+  template <class S>
+  inline friend bool operator==(const mapped_vector& m,
+                                const vector<T, S>& v) noexcept {
+    return m.size() == v.size()
+           && detail::all_columns(columns{}, [&](auto c) {
+                using key = typename decltype(c)::key;
+                return std::equal(m.storage_.template begin<key>(),
+                                  m.storage_.template end<key>(),
+                                  v.storage().template begin<key>());
+              });
+  }
+  template <class S>
+  inline friend bool operator==(const vector<T, S>& v,
+                                const mapped_vector& m) noexcept {
+    return m == v;
+  }
+
+ private:
+  storage_type storage_;
+};
+
+/// \brief Maps the file at path storing a vector of T, and reads only the
+/// columns Ks ahead of time
+///
+/// For example, load<T, k::x, k::y>(path) starts reading the columns x and y
+/// in the background; the other columns are mapped but only paged in on
+/// demand (with the default read-ahead of the kernel) if get<K> accesses
+/// them. The I/O performed is then proportional to the size of the columns
+/// used.
+template <class T, class... Ks>
+mapped_vector<T> load(const std::string& path) {
+  mapped_vector<T> v(path);
+  v.template prefetch<Ks...>();
+  return v;
+}
+
+/// \brief Element of the column K at row i of the mapped vector v
+template <class K, class T>
+[[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+decltype(auto) get(const mapped_vector<T>& v, const std::size_t i) noexcept {
+  return v.storage().template at<K>(i);
+}
+
+}  // namespace scattered
+
+#endif  // SCATTERED_DETAIL_MAPPED_VECTOR_HPP
@@ -0,0 +1,177 @@
+// (C) Copyright Gonzalo Brito Gadeschi 2014
+// Use, modification and distribution are subject to the Boost Software License,
+// Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt).
+
+/// \file \brief Bitmask queries over the columns of a scattered vector
+
+#if !defined(SCATTERED_DETAIL_MASK_HPP)
+#define SCATTERED_DETAIL_MASK_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include "assert.hpp"
+#include "bit_vector.hpp"
+#include "columns.hpp"
+#include "isa.hpp"
+#include "vector.hpp"
+
+namespace scattered {
+
+/// \brief Bitmask over the rows of a container
+using mask_type = bit_vector<>;
+
+namespace detail {
+
+template <class K, class V>
+using vector_column_value_t
+    = column_value_t<K, typename V::storage_type::columns>;
+
+template <class K, class V> struct is_bool_column
+    : std::is_same<vector_column_value_t<K, V>, bool> {};
+
+/// \name Queries over a bool column (word at a time for a bit_vector)
+///@{
+template <class A>
+[[gnu::always_inline, gnu::hot, gnu::pure]] inline
+std::size_t count_set(const bit_vector<A>& c) noexcept {
+  return c.count();
+}
+template <class Column>
+[[gnu::always_inline, gnu::hot, gnu::pure]] inline
+std::size_t count_set(const Column& c) noexcept {
+  return std::count(c.begin(), c.end(), true);
+}
+template <class A>
+[[gnu::always_inline, gnu::hot, gnu::pure]] inline
+bool any_set(const bit_vector<A>& c) noexcept {
+  return c.any();
+}
+template <class Column>
+[[gnu::always_inline, gnu::hot, gnu::pure]] inline
+bool any_set(const Column& c) noexcept {
+  return std::find(c.begin(), c.end(), true) != c.end();
+}
+template <class A>
+[[gnu::always_inline, gnu::hot, gnu::pure]] inline
+bool all_set(const bit_vector<A>& c) noexcept {
+  return c.all();
+}
+template <class Column>
+[[gnu::always_inline, gnu::hot, gnu::pure]] inline
+bool all_set(const Column& c) noexcept {
+  return std::find(c.begin(), c.end(), false) == c.end();
+}
+///@}
+
+/// \brief Sets the bit i of the words of a mask to pred(first[i]) for i in
+/// [0, n)
+///
+/// The bits are accumulated without branches, one word at a time.
+template <class It, class P>
+[[gnu::always_inline, gnu::hot]] inline
+void mask_loop(It first, const std::size_t n, P& pred,
+               mask_type::word_type* words) {
+  using word_type = mask_type::word_type;
+  std::size_t i = 0;
+  for (; n - i >= bits_per_word; i += bits_per_word, first += bits_per_word) {
+    word_type w = 0;
+    for (std::size_t j = 0; j != bits_per_word; ++j) {
+      w |= word_type(pred(first[j]) ? 1 : 0) << j;
+    }
+    words[i / bits_per_word] = w;
+  }
+  word_type w = 0;
+  for (std::size_t j = 0; i + j != n; ++j) {
+    w |= word_type(pred(first[j]) ? 1 : 0) << j;
+  }
+  if (i != n) { words[i / bits_per_word] = w; }
+}
+SCATTERED_MULTIVERSIONED(mask_kernel, mask_loop);
+
+/// \brief Bitmask whose bit i is pred(first[i]) for i in [0, n)
+template <class It, class P>
+mask_type make_mask(It first, const std::size_t n, P&& pred) {
+  mask_type result(n);
+  mask_kernel::call(first, n, pred, result.words());
+  return result;
+}
+
+[[gnu::always_inline, gnu::hot]] inline
+mask_type to_mask(const mask_type& c) { return c; }
+template <class Column> mask_type to_mask(const Column& c) {
+  return make_mask(c.begin(), c.size(), [](bool b) { return b; });
+}
+
+[[gnu::always_inline, gnu::hot]] inline
+void assign_mask(mask_type& c, const mask_type& m) { c = m; }
+template <class Column> void assign_mask(Column& c, const mask_type& m) {
+  std::copy(m.begin(), m.end(), c.begin());
+}
+
+}  // namespace detail
+
+/// \name Bool column queries
+///
+/// For the default storage, bool columns are bit_vectors, and these queries
+/// run a word (64 rows) at a time.
+///@{
+/// \brief Number of rows of v whose bool column K is true
+template <class K, class T, class S>
+std::size_t count(const vector<T, S>& v) noexcept {
+  static_assert(detail::is_bool_column<K, vector<T, S>>::value,
+                "the column must be a bool column");
+  return detail::count_set(v.template data<K>());
+}
+/// \brief Is the bool column K of any row of v true?
+template <class K, class T, class S> bool any(const vector<T, S>& v) noexcept {
+  static_assert(detail::is_bool_column<K, vector<T, S>>::value,
+                "the column must be a bool column");
+  return detail::any_set(v.template data<K>());
+}
+/// \brief Is the bool column K of every row of v true? (true if v is empty)
+template <class K, class T, class S> bool all(const vector<T, S>& v) noexcept {
+  static_assert(detail::is_bool_column<K, vector<T, S>>::value,
+                "the column must be a bool column");
+  return detail::all_set(v.template data<K>());
+}
+/// \brief Is the bool column K of every row of v false?
+template <class K, class T, class S>
+bool none(const vector<T, S>& v) noexcept {
+  return !any<K>(v);
+}
+///@}
+
+/// \name Bitmasks
+///@{
+/// \brief Bitmask whose bit i is pred(get<K>(v, i))
+///
+/// Only the column K is read. The masks of several predicates can be
+/// combined with &, | and ~, and consumed with mask_type::for_each_set or
+/// assign<K>.
+template <class K, class T, class S, class P>
+mask_type mask(const vector<T, S>& v, P&& pred) {
+  return detail::make_mask(v.storage().template begin<K>(), v.size(),
+                           std::forward<P>(pred));
+}
+/// \brief Bitmask of the bool column K of v
+template <class K, class T, class S> mask_type mask(const vector<T, S>& v) {
+  static_assert(detail::is_bool_column<K, vector<T, S>>::value,
+                "the column must be a bool column");
+  return detail::to_mask(v.template data<K>());
+}
+/// \brief Sets the bool column K of v to the bitmask m
+template <class K, class T, class S>
+void assign(vector<T, S>& v, const mask_type& m) {
+  static_assert(detail::is_bool_column<K, vector<T, S>>::value,
+                "the column must be a bool column");
+  ASSERT(m.size() == v.size(), "the mask must have a bit per row");
+  auto&& c = v.template data<K>();
+  detail::assign_mask(c, m);
+}
+///@}
+
+}  // namespace scattered
+
+#endif  // SCATTERED_DETAIL_MASK_HPP
@@ -0,0 +1,73 @@
+// (C) Copyright Gonzalo Brito Gadeschi 2014
+// Use, modification and distribution are subject to the Boost Software License,
+// Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt).
+
+/// \file \brief Fork/join helpers for the parallel algorithms
+
+#if !defined(SCATTERED_DETAIL_PARALLEL_HPP)
+#define SCATTERED_DETAIL_PARALLEL_HPP
+
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace scattered {
+
+namespace detail {
+
+/// \brief Number of threads used by default: one per hardware thread
+inline std::size_t default_no_threads() noexcept {
+  const auto n = std::thread::hardware_concurrency();
+  return n > 0 ? n : 1;
+}
+
+/// \brief Rows per chunk when n rows are split among no_threads threads
+///
+/// The chunk size is a multiple of grain and at least grain.
+[[gnu::always_inline, gnu::const]] inline
+constexpr std::size_t chunk_size(const std::size_t n,
+                                 const std::size_t no_threads,
+                                 const std::size_t grain) noexcept {
+  return no_threads > 1
+             ? ((n + no_threads - 1) / no_threads + grain - 1) / grain * grain
+             : (n > grain ? n : grain);
+}
+
+/// \brief Calls f(first, last) for the chunks of [0, n) in parallel
+///
+/// The chunks start at multiples of chunk_size(n, no_threads, grain); the
+/// first one runs on the calling thread. Returns after every chunk is done
+/// and rethrows the first exception thrown by f, if any.
+///
+/// \note With grain = bits_per_word, threads never write to the same word of
+/// a packed bool column.
+template <class F>
+void parallel_for(const std::size_t n, const std::size_t no_threads,
+                  const std::size_t grain, F&& f) {
+  if (n == 0) { return; }
+  const std::size_t chunk = chunk_size(n, no_threads, grain);
+  const std::size_t no_chunks = (n + chunk - 1) / chunk;
+  std::vector<std::exception_ptr> errors(no_chunks);
+  auto run = [&](const std::size_t c) {
+    try {
+      const std::size_t first = c * chunk;
+      f(first, first + chunk < n ? first + chunk : n);
+    } catch (...) { errors[c] = std::current_exception(); }
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(no_chunks - 1);
+  for (std::size_t c = 1; c < no_chunks; ++c) { threads.emplace_back(run, c); }
+  run(0);
+  for (auto& t : threads) { t.join(); }
+  for (auto& e : errors) {
+    if (e) { std::rethrow_exception(e); }
+  }
+}
+
+}  // namespace detail
+
+}  // namespace scattered
+
+#endif  // SCATTERED_DETAIL_PARALLEL_HPP
@@ -0,0 +1,310 @@
+// (C) Copyright Gonzalo Brito Gadeschi 2014
+// Use, modification and distribution are subject to the Boost Software License,
+// Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt).
+
+/// \file \brief Storage whose columns grow in reserved address space
+
+#if !defined(SCATTERED_DETAIL_RESERVED_STORAGE_HPP)
+#define SCATTERED_DETAIL_RESERVED_STORAGE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#else
+#error "scattered::reserved_storage requires mmap"
+#endif
+#include "assert.hpp"
+#include "container_storage.hpp"
+
+namespace scattered {
+
+namespace detail {
+
+/// \brief Size in bytes of a page
+inline std::size_t page_size() noexcept {
+  static const std::size_t size = ::sysconf(_SC_PAGESIZE);
+  return size;
+}
+
+[[gnu::always_inline]] inline
+std::size_t round_up_to_pages(const std::size_t n) noexcept {
+  const std::size_t p = page_size();
+  return (n + p - 1) / p * p;
+}
+
+#if defined(MAP_NORESERVE)
+static const constexpr int map_noreserve = MAP_NORESERVE;
+#else
+static const constexpr int map_noreserve = 0;
+#endif
+
+/// \brief Reserves bytes of address space without committing memory
+inline void* reserve_address_space(const std::size_t bytes) {
+  void* p = ::mmap(nullptr, bytes, PROT_NONE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | map_noreserve, -1, 0);
+  if (p == MAP_FAILED) { throw std::bad_alloc(); }
+  return p;
+}
+
+/// \brief Commits the reserved pages [p, p + bytes)
+inline void commit_pages(void* p, const std::size_t bytes) {
+  if (bytes == 0) { return; }
+  if (::mprotect(p, bytes, PROT_READ | PROT_WRITE) != 0) {
+    throw std::bad_alloc();
+  }
+}
+
+/// \brief Returns the pages [p, p + bytes) to the system but keeps them
+/// reserved
+inline void decommit_pages(void* p, const std::size_t bytes) noexcept {
+  if (bytes == 0) { return; }
+  ::mmap(p, bytes, PROT_NONE,
+         MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | map_noreserve, -1, 0);
+}
+
+}  // namespace detail
+
+/// \brief Vector that reserves address space for MaxSize elements on its
+/// first allocation and commits pages as it grows
+///
+/// Growing never reallocates: the elements are never copied or moved by
+/// push_back, resize or reserve, and pointers and iterators to them stay
+/// valid until they are erased. Growing past MaxSize elements throws
+/// std::bad_alloc. Only the committed pages use memory; the reservation
+/// only uses address space (MaxSize * sizeof(T) bytes).
+template <class T, std::size_t MaxSize = (std::size_t(1) << 30)>
+class reserved_vector {
+ public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = T&;
+  using const_reference = T const&;
+  using pointer = T*;
+  using const_pointer = T const*;
+  using iterator = T*;
+  using const_iterator = T const*;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  static_assert(MaxSize > 0, "the reservation must hold at least one element");
+
+  /// \name Constructors
+  ///@{
+  reserved_vector() noexcept = default;
+  // These delegate to the default constructor so that the reservation is
+  // released if constructing an element throws:
+  explicit reserved_vector(const size_type n) : reserved_vector() {
+    resize(n);
+  }
+  reserved_vector(const reserved_vector& other) : reserved_vector() {
+    reserve(other.size_);
+    std::uninitialized_copy(other.begin(), other.end(), data_);
+    size_ = other.size_;
+  }
+  reserved_vector(reserved_vector&& other) noexcept { steal(other); }
+  reserved_vector& operator=(const reserved_vector& other) {
+    if (this != &other) {
+      reserved_vector tmp(other);
+      swap(*this, tmp);
+    }
+    return *this;
+  }
+  reserved_vector& operator=(reserved_vector&& other) noexcept {
+    if (this != &other) {
+      release();
+      steal(other);
+    }
+    return *this;
+  }
+  ~reserved_vector() { release(); }
+  ///@}
+
+  /// \name Iterators
+  ///@{
+  iterator begin() noexcept { return data_; }
+  iterator end() noexcept { return data_ + size_; }
+  const_iterator begin() const noexcept { return data_; }
+  const_iterator end() const noexcept { return data_ + size_; }
+  const_iterator cbegin() const noexcept { return data_; }
+  const_iterator cend() const noexcept { return data_ + size_; }
+  reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+  reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+  const_reverse_iterator rbegin() const noexcept {
+    return const_reverse_iterator(end());
+  }
+  const_reverse_iterator rend() const noexcept {
+    return const_reverse_iterator(begin());
+  }
+  ///@}
+
+  /// \name Element access
+  ///@{
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  reference operator[](const size_type i) noexcept { return data_[i]; }
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  const_reference operator[](const size_type i) const noexcept {
+    return data_[i];
+  }
+  reference front() noexcept { return data_[0]; }
+  const_reference front() const noexcept { return data_[0]; }
+  reference back() noexcept { return data_[size_ - 1]; }
+  const_reference back() const noexcept { return data_[size_ - 1]; }
+  T* data() noexcept { return data_; }
+  T const* data() const noexcept { return data_; }
+  ///@}
+
+  /// \name Capacity
+  ///@{
+  bool empty() const noexcept { return size_ == 0; }
+  size_type size() const noexcept { return size_; }
+  /// \brief Number of elements that fit in the committed pages
+  size_type capacity() const noexcept {
+    const size_type n = committed_ / sizeof(T);
+    return n < MaxSize ? n : MaxSize;
+  }
+  static constexpr size_type max_size() noexcept { return MaxSize; }
+  /// \brief Commits the pages needed to store n elements
+  void reserve(const size_type n) { commit(n); }
+  /// \brief Decommits the pages past the last element (and releases the
+  /// reservation if the vector is empty)
+  void shrink_to_fit() noexcept {
+    if (size_ == 0) {
+      release();
+      return;
+    }
+    const size_type used = detail::round_up_to_pages(size_ * sizeof(T));
+    detail::decommit_pages(bytes() + used, committed_ - used);
+    committed_ = used;
+  }
+  ///@}
+
+  /// \name Modifiers
+  ///@{
+  void clear() noexcept { destroy_tail(0); }
+  void resize(const size_type n) {
+    if (n <= size_) {
+      destroy_tail(n);
+      return;
+    }
+    grow(n);
+    for (; size_ != n; ++size_) { ::new (data_ + size_) T(); }
+  }
+  void resize(const size_type n, const T& value) {
+    if (n <= size_) {
+      destroy_tail(n);
+      return;
+    }
+    grow(n);
+    for (; size_ != n; ++size_) { ::new (data_ + size_) T(value); }
+  }
+  template <class... Args> reference emplace_back(Args&&... args) {
+    grow(size_ + 1);
+    ::new (data_ + size_) T(std::forward<Args>(args)...);
+    return data_[size_++];
+  }
+  void push_back(const T& value) { emplace_back(value); }
+  void push_back(T&& value) { emplace_back(std::move(value)); }
+  void pop_back() noexcept {
+    ASSERT(size_ > 0, "pop_back on an empty reserved_vector");
+    destroy_tail(size_ - 1);
+  }
+  /// \brief Inserts n copies of value before pos
+  iterator insert(const_iterator pos, const size_type n, const T& value) {
+    const size_type first = pos - data_;
+    const size_type old_size = size_;
+    resize(size_ + n, value);
+    std::rotate(data_ + first, data_ + old_size, data_ + size_);
+    return data_ + first;
+  }
+  /// \brief Erases the elements [first, last)
+  iterator erase(const_iterator first, const_iterator last) {
+    const auto f = data_ + (first - data_);
+    const auto l = data_ + (last - data_);
+    std::move(l, end(), f);
+    destroy_tail(size_ - (l - f));
+    return f;
+  }
+  iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+  inline friend void swap(reserved_vector& a, reserved_vector& b) noexcept {
+    std::swap(a.data_, b.data_);
+    std::swap(a.size_, b.size_);
+    std::swap(a.committed_, b.committed_);
+  }
+  ///@}
+
+ private:
+  T* data_ = nullptr;       ///< First element of the reservation
+  size_type size_ = 0;      ///< Number of elements
+  size_type committed_ = 0; ///< Number of committed bytes
+
+  static size_type reserved_bytes() noexcept {
+    return detail::round_up_to_pages(MaxSize * sizeof(T));
+  }
+  char* bytes() const noexcept { return reinterpret_cast<char*>(data_); }
+
+  /// \brief Commits the pages needed to store n elements
+  void commit(const size_type n) {
+    if (n > MaxSize) { throw std::bad_alloc(); }
+    const size_type required = detail::round_up_to_pages(n * sizeof(T));
+    if (required <= committed_) { return; }
+    if (!data_) {
+      data_ = static_cast<T*>(detail::reserve_address_space(reserved_bytes()));
+    }
+    detail::commit_pages(bytes() + committed_, required - committed_);
+    committed_ = required;
+  }
+  /// \brief Commits the pages for at least n elements, doubling the
+  /// committed memory to amortize the system calls
+  void grow(const size_type n) {
+    if (n <= capacity()) { return; }
+    if (n > MaxSize) { throw std::bad_alloc(); }
+    const size_type twice = 2 * capacity();
+    const size_type m = n > twice ? n : (twice < MaxSize ? twice : MaxSize);
+    commit(m);
+  }
+  void destroy_tail(const size_type n) noexcept {
+    for (size_type i = n; i != size_; ++i) { data_[i].~T(); }
+    size_ = n;
+  }
+  void release() noexcept {
+    clear();
+    if (data_) { ::munmap(data_, reserved_bytes()); }
+    data_ = nullptr;
+    committed_ = 0;
+  }
+  void steal(reserved_vector& other) noexcept {
+    data_ = other.data_;
+    size_ = other.size_;
+    committed_ = other.committed_;
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.committed_ = 0;
+  }
+};
+
+/// \brief reserved_vector with a reservation of MaxSize elements
+template <std::size_t MaxSize> struct reserved_vector_container {
+  template <class T> using type = reserved_vector<T, MaxSize>;
+};
+
+/// \brief Storage policy: each column is a reserved_vector that reserves
+/// address space for MaxRows rows and commits pages as the vector grows
+///
+/// push_back and resize never copy the existing rows, and pointers to the
+/// elements of the columns stay valid while the vector grows. bool columns
+/// are stored one byte per row.
+template <std::size_t MaxRows = (std::size_t(1) << 30)>
+using reserved_storage = container_storage
+    <reserved_vector_container<MaxRows>::template type>;
+
+}  // namespace scattered
+
+#endif  // SCATTERED_DETAIL_RESERVED_STORAGE_HPP
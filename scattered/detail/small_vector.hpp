@@ -0,0 +1,40 @@
+// (C) Copyright Gonzalo Brito Gadeschi 2014
+// Use, modification and distribution are subject to the Boost Software License,
+// Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt).
+
+/// \file \brief Implements the scattered vector with inline storage
+
+#if !defined(SCATTERED_DETAIL_SMALL_VECTOR_HPP)
+#define SCATTERED_DETAIL_SMALL_VECTOR_HPP
+
+#include <cstddef>
+#include <memory>
+#include "column_arena.hpp"
+#include "vector.hpp"
+
+namespace scattered {
+
+/// \brief Storage policy: the first N rows of every column are stored inside
+/// the vector object, and all the columns move together to a single heap
+/// allocation when the vector grows past N rows (see arena_storage)
+///
+/// Vectors of at most N rows do not allocate. Moving or swapping a vector
+/// whose rows are stored inline moves its rows one by one.
+template <std::size_t N, class Allocator = std::allocator<char>>
+struct small_storage {
+  static_assert(N > 0, "the inline capacity must be at least one row");
+  template <class Columns>
+  using storage_type = detail::column_arena
+      <Columns, detail::contiguous_layout<Columns>, Allocator, N>;
+};
+
+/// \brief Scattered vector that stores up to N rows inline
+///
+/// Its interface is that of scattered::vector.
+template <class T, std::size_t N, class Allocator = std::allocator<char>>
+using small_vector = vector<T, small_storage<N, Allocator>>;
+
+}  // namespace scattered
+
+#endif  // SCATTERED_DETAIL_SMALL_VECTOR_HPP
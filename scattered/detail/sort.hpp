@@ -0,0 +1,397 @@
+// (C) Copyright Gonzalo Brito Gadeschi 2014
+// Use, modification and distribution are subject to the Boost Software License,
+// Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt).
+
+/// \file \brief Sorting scattered vectors by a key column
+
+#if !defined(SCATTERED_DETAIL_SORT_HPP)
+#define SCATTERED_DETAIL_SORT_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <boost/container/vector.hpp>
+#include "assert.hpp"
+#include "bit_vector.hpp"
+#include "columns.hpp"
+#include "executor.hpp"
+#include "vector.hpp"
+
+namespace scattered {
+
+/// \brief Permutation of the rows of a vector: the row i of the permuted
+/// vector is the row p[i] of the original vector
+using permutation = std::vector<std::size_t>;
+
+/// \brief Permutation that stably sorts the column K of v with respect to cmp
+///
+/// Only the column K is read: the (key, row) pairs are sorted contiguously,
+/// so that the comparisons do not chase indices into the column.
+template <class K, class T, class S, class Compare = std::less<>>
+permutation argsort(const vector<T, S>& v, Compare cmp = Compare{}) {
+  using value_type = detail::column_value_t<K, detail::columns_of_t<T>>;
+  std::vector<std::pair<value_type, std::size_t>> keys;
+  keys.reserve(v.size());
+  std::size_t i = 0;
+  for (auto it = v.storage().template begin<K>(),
+            e = v.storage().template end<K>();
+       it != e; ++it, ++i) {
+    keys.emplace_back(*it, i);
+  }
+  std::stable_sort(keys.begin(), keys.end(), [&](auto const& a, auto const& b) {
+    return cmp(a.first, b.first);
+  });
+  permutation p(keys.size());
+  for (std::size_t j = 0; j != keys.size(); ++j) { p[j] = keys[j].second; }
+  return p;
+}
+
+/// \brief Reorders the rows of v by p, one column at a time
+///
+/// Each column is gathered into a buffer (sequential writes, reads at p) and
+/// moved back, so the extra memory is that of one column.
+template <class T, class S>
+void permute(vector<T, S>& v, const permutation& p) {
+  ASSERT(p.size() == v.size(), "the permutation must have a row per row");
+  using columns = detail::columns_of_t<T>;
+  detail::for_each_column(columns{}, [&](auto c) {
+    using K = typename decltype(c)::key;
+    using V = typename decltype(c)::value_type;
+    const auto first = v.storage().template begin<K>();
+    boost::container::vector<V> buffer(p.size(),
+                                       boost::container::default_init);
+    for (std::size_t i = 0; i != p.size(); ++i) {
+      buffer[i] = std::move(first[p[i]]);
+    }
+    std::move(buffer.begin(), buffer.end(), first);
+  });
+}
+
+/// \brief Reorders the rows of v by p in place, one column at a time
+///
+/// The cycles of p are followed with one temporary value per column and a
+/// bit per row, so no column buffer is allocated.
+template <class T, class S>
+void permute_in_place(vector<T, S>& v, const permutation& p) {
+  ASSERT(p.size() == v.size(), "the permutation must have a row per row");
+  using columns = detail::columns_of_t<T>;
+  bit_vector<> done(p.size());
+  detail::for_each_column(columns{}, [&](auto c) {
+    using K = typename decltype(c)::key;
+    using V = typename decltype(c)::value_type;
+    const auto first = v.storage().template begin<K>();
+    for (std::size_t i = 0; i != p.size(); ++i) {
+      if (done[i]) { continue; }
+      V tmp = std::move(first[i]);
+      std::size_t j = i;
+      for (; p[j] != i; j = p[j]) {
+        first[j] = std::move(first[p[j]]);
+        done[j] = true;
+      }
+      first[j] = std::move(tmp);
+      done[j] = true;
+    }
+    std::fill(done.words(), done.words() + done.no_words(), 0);
+  });
+}
+
+/// \brief Stably sorts the rows of v by their column K with respect to cmp
+///
+/// Unlike sorting the rows with std::sort, the comparisons only read the
+/// column K, and every column is reordered once (see argsort and permute).
+template <class K, class T, class S, class Compare = std::less<>>
+void sort_by(vector<T, S>& v, Compare cmp = Compare{}) {
+  permute(v, argsort<K>(v, cmp));
+}
+
+namespace detail {
+
+/// \brief Number of elements i of a[0, m) such that a[0, i) and b[0, k - i)
+/// are the first k elements of the stable merge of a[0, m) and b[0, n)
+template <class It, class Compare>
+std::size_t co_rank(const std::size_t k, It a, const std::size_t m, It b,
+                    const std::size_t n, Compare& cmp) {
+  std::size_t lo = k > n ? k - n : 0;
+  std::size_t hi = k < m ? k : m;
+  while (lo < hi) {
+    const std::size_t i = lo + (hi - lo) / 2;
+    const std::size_t j = k - i;
+    if (j > 0 && !cmp(b[j - 1], a[i])) {
+      lo = i + 1;
+    } else {
+      hi = i;
+    }
+  }
+  return lo;
+}
+
+/// \brief Stably merges the consecutive sorted runs of [first, first + n) of
+/// length width pairwise into [out, out + n)
+///
+/// Every merge is split into parts of equal output length (found with
+/// co_rank), so that all threads have work even when there are less pairs of
+/// runs than threads.
+template <class It, class Out, class Compare, class Executor>
+void merge_runs(It first, const std::size_t n, const std::size_t width,
+                Out out, Compare& cmp, Executor& e) {
+  const std::size_t no_threads = no_threads_of(e);
+  const std::size_t no_pairs = (n + 2 * width - 1) / (2 * width);
+  const std::size_t no_parts = (no_threads + no_pairs - 1) / no_pairs;
+  e.parallel_for(no_pairs * no_parts, 1, [&](std::size_t f, std::size_t l) {
+    for (; f != l; ++f) {
+      const std::size_t lo = f / no_parts * 2 * width;
+      const std::size_t mid = lo + width < n ? lo + width : n;
+      const std::size_t hi = mid + width < n ? mid + width : n;
+      const std::size_t m = mid - lo, k = hi - lo, part = f % no_parts;
+      const std::size_t k0 = k * part / no_parts;
+      const std::size_t k1 = k * (part + 1) / no_parts;
+      const auto a = first + lo, b = first + mid;
+      const std::size_t i0 = co_rank(k0, a, m, b, k - m, cmp);
+      const std::size_t i1 = co_rank(k1, a, m, b, k - m, cmp);
+      std::merge(a + i0, a + i1, b + (k0 - i0), b + (k1 - i1), out + lo + k0,
+                 cmp);
+    }
+  });
+}
+
+}  // namespace detail
+
+/// \name Parallel sorting
+///
+/// The parallel algorithms run on the executor e, or on a thread_executor if
+/// e is a number of threads.
+///@{
+/// \brief Permutation that stably sorts the column K of v with respect to cmp
+///
+/// The (key, row) pairs are split into one run per thread, the runs are
+/// sorted in parallel, and then merged pairwise in parallel. The result is
+/// that of argsort<K>(v, cmp).
+template <class K, class T, class S, class Compare = std::less<>,
+          class Executor = thread_executor>
+permutation parallel_argsort(const vector<T, S>& v, Compare cmp = Compare{},
+                             Executor&& e = Executor{}) {
+  using value_type = detail::column_value_t<K, detail::columns_of_t<T>>;
+  using key_row = std::pair<value_type, std::size_t>;
+  auto&& ex = detail::as_executor(std::forward<Executor>(e));
+  auto by_key = [&](const key_row& a, const key_row& b) {
+    return cmp(a.first, b.first);
+  };
+  const std::size_t n = v.size();
+  if (n == 0) { return {}; }
+  const auto first = v.storage().template begin<K>();
+  std::vector<key_row> keys(n), buffer(n);
+  const std::size_t width = detail::chunk_size(n, detail::no_threads_of(ex), 1);
+  ex.parallel_for((n + width - 1) / width, 1, [&](std::size_t r,
+                                                  std::size_t l) {
+    for (; r != l; ++r) {
+      const std::size_t f = r * width, last = f + width < n ? f + width : n;
+      for (std::size_t i = f; i != last; ++i) {
+        keys[i] = key_row(first[i], i);
+      }
+      std::stable_sort(keys.begin() + f, keys.begin() + last, by_key);
+    }
+  });
+  for (std::size_t w = width; w < n; w *= 2) {
+    detail::merge_runs(keys.begin(), n, w, buffer.begin(), by_key, ex);
+    keys.swap(buffer);
+  }
+  permutation p(n);
+  ex.parallel_for(n, 1, [&](std::size_t f, std::size_t l) {
+    for (std::size_t i = f; i != l; ++i) { p[i] = keys[i].second; }
+  });
+  return p;
+}
+
+/// \brief Reorders the rows of v by p, one column at a time
+///
+/// Every column is gathered and moved back by row ranges in parallel. The
+/// ranges are multiples of 64 rows so that no two threads write to the same
+/// word of a packed bool column.
+template <class T, class S, class Executor = thread_executor>
+void parallel_permute(vector<T, S>& v, const permutation& p,
+                      Executor&& e = Executor{}) {
+  ASSERT(p.size() == v.size(), "the permutation must have a row per row");
+  using columns = detail::columns_of_t<T>;
+  auto&& ex = detail::as_executor(std::forward<Executor>(e));
+  const std::size_t grain = detail::bits_per_word;
+  detail::for_each_column(columns{}, [&](auto c) {
+    using K = typename decltype(c)::key;
+    using V = typename decltype(c)::value_type;
+    const auto first = v.storage().template begin<K>();
+    boost::container::vector<V> buffer(p.size(),
+                                       boost::container::default_init);
+    ex.parallel_for(p.size(), grain, [&](std::size_t f, std::size_t l) {
+      for (std::size_t i = f; i != l; ++i) {
+        buffer[i] = std::move(first[p[i]]);
+      }
+    });
+    ex.parallel_for(p.size(), grain, [&](std::size_t f, std::size_t l) {
+      std::move(buffer.begin() + f, buffer.begin() + l, first + f);
+    });
+  });
+}
+
+/// \brief Stably sorts the rows of v by their column K with respect to cmp
+/// (see parallel_argsort and parallel_permute)
+template <class K, class T, class S, class Compare = std::less<>,
+          class Executor = thread_executor>
+void parallel_sort_by(vector<T, S>& v, Compare cmp = Compare{},
+                      Executor&& e = Executor{}) {
+  auto&& ex = detail::as_executor(std::forward<Executor>(e));
+  parallel_permute(v, parallel_argsort<K>(v, cmp, ex), ex);
+}
+///@}
+
+namespace detail {
+
+/// \brief Maps values of type V to unsigned integers of the same order, so
+/// that they can be sorted one byte at a time
+///
+/// Signed integers get their sign bit flipped. Floating-point numbers get
+/// their sign bit flipped if they are positive, and all of their bits
+/// flipped if they are negative, so that -0.0 precedes 0.0 and NaNs (with
+/// the sign bit unset) follow infinity.
+template <class V, class = void> struct radix_key;
+
+template <class V>
+struct radix_key<V, std::enable_if_t<std::is_integral<V>{}
+                                     && !std::is_same<V, bool>{}>> {
+  using type = std::make_unsigned_t<V>;
+  [[gnu::always_inline, gnu::const]] inline
+  static type to_key(const V v) noexcept {
+    return std::is_signed<V>{}
+               ? static_cast<type>(static_cast<type>(v)
+                                   ^ (type(1) << (sizeof(type) * 8 - 1)))
+               : static_cast<type>(v);
+  }
+};
+
+template <> struct radix_key<bool> {
+  using type = std::uint8_t;
+  [[gnu::always_inline, gnu::const]] inline
+  static type to_key(const bool v) noexcept {
+    return v;
+  }
+};
+
+template <class V> struct radix_key<V, std::enable_if_t<std::is_enum<V>{}>> {
+  using underlying = radix_key<std::underlying_type_t<V>>;
+  using type = typename underlying::type;
+  [[gnu::always_inline, gnu::const]] inline
+  static type to_key(const V v) noexcept {
+    return underlying::to_key(static_cast<std::underlying_type_t<V>>(v));
+  }
+};
+
+template <class V>
+struct radix_key<V, std::enable_if_t<std::is_floating_point<V>{}>> {
+  static_assert(sizeof(V) == 4 || sizeof(V) == 8,
+                "only 32 and 64-bit floating-point keys are supported");
+  using type = std::conditional_t<sizeof(V) == 4, std::uint32_t,
+                                  std::uint64_t>;
+  [[gnu::always_inline, gnu::const]] inline
+  static type to_key(const V v) noexcept {
+    type u;
+    std::memcpy(&u, &v, sizeof(V));
+    const type sign = type(1) << (sizeof(type) * 8 - 1);
+    return (u & sign) ? ~u : (u | sign);
+  }
+};
+
+/// \brief Stably sorts keys and p by keys, one byte at a time from the least
+/// significant byte
+///
+/// The histograms of all bytes are computed in a single pass, and the bytes
+/// that are equal for all the keys are skipped.
+template <class U> void radix_sort_keys(std::vector<U>& keys, permutation& p) {
+  const std::size_t n = keys.size();
+  if (n == 0) { return; }
+  static constexpr std::size_t no_bytes = sizeof(U);
+  auto digit = [](U k, std::size_t b) { return (k >> (8 * b)) & 0xff; };
+  std::vector<std::array<std::size_t, 256>> counts(no_bytes);
+  for (auto k : keys) {
+    for (std::size_t b = 0; b != no_bytes; ++b) { ++counts[b][digit(k, b)]; }
+  }
+  std::vector<U> keys_buffer(n);
+  permutation p_buffer(n);
+  for (std::size_t b = 0; b != no_bytes; ++b) {
+    auto& offsets = counts[b];
+    if (offsets[digit(keys[0], b)] == n) { continue; }
+    std::size_t sum = 0;
+    for (auto& o : offsets) {
+      const std::size_t c = o;
+      o = sum;
+      sum += c;
+    }
+    for (std::size_t i = 0; i != n; ++i) {
+      const std::size_t o = offsets[digit(keys[i], b)]++;
+      keys_buffer[o] = keys[i];
+      p_buffer[o] = p[i];
+    }
+    keys.swap(keys_buffer);
+    p.swap(p_buffer);
+  }
+}
+
+/// \brief Stably sorts the permutation p by the column K of v
+template <class K, class T, class S>
+void radix_pass(const vector<T, S>& v, permutation& p) {
+  using key = radix_key<column_value_t<K, columns_of_t<T>>>;
+  const auto first = v.storage().template begin<K>();
+  std::vector<typename key::type> keys(p.size());
+  for (std::size_t i = 0; i != p.size(); ++i) {
+    keys[i] = key::to_key(first[p[i]]);
+  }
+  radix_sort_keys(keys, p);
+}
+
+/// \brief Sorts a permutation by the keys Ks, the last key first
+template <class... Ks> struct radix_passes;
+
+template <> struct radix_passes<> {
+  template <class V> static void apply(const V&, permutation&) noexcept {}
+};
+
+template <class K, class... Ks> struct radix_passes<K, Ks...> {
+  template <class V> static void apply(const V& v, permutation& p) {
+    radix_passes<Ks...>::apply(v, p);
+    radix_pass<K>(v, p);
+  }
+};
+
+}  // namespace detail
+
+/// \brief Permutation that stably sorts the rows of v in ascending order of
+/// the columns Ks (lexicographically: the first key is the most significant)
+///
+/// The columns Ks must be of arithmetic or enumeration type. Each key column
+/// is sorted with a least significant digit radix sort over the bytes of its
+/// values, from the last key to the first, and only the permutation (and not
+/// the rows) is moved between the passes.
+template <class... Ks, class T, class S>
+permutation radix_argsort(const vector<T, S>& v) {
+  static_assert(sizeof...(Ks) > 0, "radix_argsort needs at least one key");
+  permutation p(v.size());
+  std::iota(p.begin(), p.end(), std::size_t(0));
+  detail::radix_passes<Ks...>::apply(v, p);
+  return p;
+}
+
+/// \brief Stably sorts the rows of v in ascending order of the columns Ks
+/// (see radix_argsort); every column is reordered once at the end
+template <class... Ks, class T, class S> void radix_sort_by(vector<T, S>& v) {
+  permute(v, radix_argsort<Ks...>(v));
+}
+
+}  // namespace scattered
+
+#endif  // SCATTERED_DETAIL_SORT_HPP
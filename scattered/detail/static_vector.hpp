@@ -0,0 +1,271 @@
+// (C) Copyright Gonzalo Brito Gadeschi 2014
+// Use, modification and distribution are subject to the Boost Software License,
+// Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt).
+
+/// \file \brief Implements the scattered vector with a fixed capacity
+
+#if !defined(SCATTERED_DETAIL_STATIC_VECTOR_HPP)
+#define SCATTERED_DETAIL_STATIC_VECTOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "assert.hpp"
+#include "column_arena.hpp"
+#include "columns.hpp"
+#include "vector.hpp"
+
+namespace scattered {
+
+namespace detail {
+
+/// \brief Uninitialized buffer of Capacity elements of type V
+template <class V, std::size_t Capacity> struct static_column {
+  alignas(V) unsigned char bytes[Capacity * sizeof(V)];
+};
+
+/// \brief Stores each column in a buffer of Capacity elements inside the
+/// storage object
+///
+/// The storage never allocates: growing past Capacity rows throws
+/// std::bad_alloc. The offset of every column from the storage object and the
+/// capacity are compile-time constants.
+template <class Columns, std::size_t Capacity> class static_storage;
+
+template <class... Cs, std::size_t Capacity>
+class static_storage<column_list<Cs...>, Capacity> {
+ public:
+  using columns = column_list<Cs...>;
+  using size_type = std::size_t;
+  template <class U> using column_type = column_view<U>;
+  /// Maximum number of rows
+  static const constexpr std::size_t static_capacity = Capacity;
+
+ private:
+  template <class K> using index = column_index<K, columns>;
+  template <class K> using value_t = column_value_t<K, columns>;
+
+  static_assert(Capacity > 0, "the capacity must be at least one row");
+
+  /// Moving and swapping the rows only throws if moving an element throws
+  static const constexpr bool nothrow_move
+      = nothrow_move_constructible_columns<columns>::value;
+
+ public:
+  /// \name Constructors
+  ///@{
+  static_storage() noexcept = default;
+  static_storage(const static_storage& other) { append(other); }
+  static_storage(static_storage&& other) noexcept(nothrow_move) {
+    append_move(other);
+  }
+  static_storage& operator=(const static_storage& other) {
+    if (this != &other) {
+      clear();
+      append(other);
+    }
+    return *this;
+  }
+  static_storage& operator=(static_storage&& other) noexcept(nothrow_move) {
+    if (this != &other) {
+      clear();
+      append_move(other);
+    }
+    return *this;
+  }
+  ~static_storage() { clear(); }
+  ///@}
+
+  /// \name Column access
+  ///@{
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  column_type<value_t<K>> column() noexcept {
+    return {begin<K>(), size_};
+  }
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  column_type<const value_t<K>> column() const noexcept {
+    return {begin<K>(), size_};
+  }
+
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  value_t<K>* begin() noexcept {
+    return reinterpret_cast<value_t<K>*>(
+        std::get<index<K>::value>(columns_).bytes);
+  }
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  value_t<K> const* begin() const noexcept {
+    return reinterpret_cast<value_t<K> const*>(
+        std::get<index<K>::value>(columns_).bytes);
+  }
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  value_t<K>* end() noexcept { return begin<K>() + size_; }
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  value_t<K> const* end() const noexcept { return begin<K>() + size_; }
+
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  value_t<K>& at(const size_type i) noexcept { return begin<K>()[i]; }
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  value_t<K> const& at(const size_type i) const noexcept {
+    return begin<K>()[i];
+  }
+  ///@}
+
+  /// \name Capacity
+  ///@{
+  size_type size() const noexcept { return size_; }
+  static constexpr size_type capacity() noexcept { return Capacity; }
+  static constexpr size_type max_size() noexcept { return Capacity; }
+  void reserve(const size_type n) { check_capacity(n); }
+  void shrink_to_fit() noexcept {}
+  ///@}
+
+  /// \name Modifiers
+  ///@{
+  void clear() noexcept { resize_down(0); }
+  void resize(const size_type n) {
+    if (n <= size_) {
+      resize_down(n);
+      return;
+    }
+    check_capacity(n);
+    for_each_column_or_undo(columns{}, [&](auto c) {
+      using K = typename decltype(c)::key;
+      using V = value_t<K>;
+      const auto first = end<K>();
+      size_type i = 0;
+      try {
+        for (; i != n - size_; ++i) { ::new (first + i) V(); }
+      } catch (...) {
+        destroy_n(first, i);
+        throw;
+      }
+    }, [&](auto c) { destroy_n(end<typename decltype(c)::key>(), n - size_); });
+    size_ = n;
+  }
+  /// \brief Inserts n value-initialized rows before the row pos
+  void insert(const size_type pos, const size_type n) {
+    ASSERT(pos <= size_, "insert position out of bounds");
+    const auto old_size = size_;
+    resize(size_ + n);
+    for_each_column(columns{}, [&](auto c) {
+      using K = typename decltype(c)::key;
+      const auto first = begin<K>();
+      std::move_backward(first + pos, first + old_size, first + old_size + n);
+      std::fill(first + pos, first + pos + n, value_t<K>());
+    });
+  }
+  /// \brief Erases the rows [pos, pos + n)
+  void erase(const size_type pos, const size_type n) {
+    ASSERT(pos + n <= size_, "erase range out of bounds");
+    for_each_column(columns{}, [&](auto c) {
+      using K = typename decltype(c)::key;
+      const auto first = begin<K>();
+      std::move(first + pos + n, first + size_, first + pos);
+    });
+    resize_down(size_ - n);
+  }
+  /// \brief Appends a row whose column C is constructed from f(C{})
+  template <class F> void emplace_back(F&& f) {
+    check_capacity(size_ + 1);
+    for_each_column_or_undo(columns{}, [&](auto c) {
+      using K = typename decltype(c)::key;
+      ::new (end<K>()) value_t<K>(f(c));
+    }, [&](auto c) { destroy_n(end<typename decltype(c)::key>(), 1); });
+    ++size_;
+  }
+  void pop_back() noexcept {
+    ASSERT(size_ > 0, "pop_back on empty storage");
+    resize_down(size_ - 1);
+  }
+  /// \brief Swaps the rows of a and b (elementwise, linear in their sizes)
+  inline friend void swap(static_storage& a,
+                          static_storage& b) noexcept(nothrow_move) {
+    if (&a == &b) { return; }
+    static_storage tmp(std::move(a));
+    a = std::move(b);
+    b = std::move(tmp);
+  }
+  ///@}
+
+ private:
+  std::tuple<static_column<typename Cs::value_type, Capacity>...> columns_;
+  size_type size_ = 0;
+
+  static void check_capacity(const size_type n) {
+    if (n > Capacity) { throw std::bad_alloc(); }
+  }
+
+  void resize_down(const size_type n) noexcept {
+    ASSERT(n <= size_, "resize_down cannot grow the storage");
+    for_each_column(columns{}, [&](auto c) {
+      destroy_n(begin<typename decltype(c)::key>() + n, size_ - n);
+    });
+    size_ = n;
+  }
+
+  /// \brief Copies the rows of other after the rows of *this (*this must be
+  /// empty)
+  void append(const static_storage& other) {
+    ASSERT(size_ == 0, "append into a non-empty storage");
+    for_each_column_or_undo(columns{}, [&](auto c) {
+      using K = typename decltype(c)::key;
+      std::uninitialized_copy(other.template begin<K>(),
+                              other.template end<K>(), begin<K>());
+    }, [&](auto c) {
+      destroy_n(begin<typename decltype(c)::key>(), other.size_);
+    });
+    size_ = other.size_;
+  }
+  /// \brief Moves the rows of other into *this (which must be empty) and
+  /// clears other
+  void append_move(static_storage& other) {
+    ASSERT(size_ == 0, "append into a non-empty storage");
+    for_each_column_or_undo(columns{}, [&](auto c) {
+      using K = typename decltype(c)::key;
+      std::uninitialized_copy(
+          std::make_move_iterator(other.template begin<K>()),
+          std::make_move_iterator(other.template end<K>()), begin<K>());
+    }, [&](auto c) {
+      destroy_n(begin<typename decltype(c)::key>(), other.size_);
+    });
+    size_ = other.size_;
+    other.clear();
+  }
+};
+
+}  // namespace detail
+
+/// \brief Storage policy: every column is a buffer of Capacity elements
+/// inside the vector object
+///
+/// The vector never allocates, and growing it past Capacity rows throws
+/// std::bad_alloc. Since the capacity and the offsets of the columns are
+/// compile-time constants, loops over a full column have a known trip count.
+template <std::size_t Capacity> struct static_storage {
+  template <class Columns>
+  using storage_type = detail::static_storage<Columns, Capacity>;
+};
+
+/// \brief Scattered vector with a fixed capacity of Capacity rows
+///
+/// Its interface is that of scattered::vector.
+template <class T, std::size_t Capacity>
+using static_vector = vector<T, static_storage<Capacity>>;
+
+}  // namespace scattered
+
+#endif  // SCATTERED_DETAIL_STATIC_VECTOR_HPP
@@ -0,0 +1,261 @@
+// (C) Copyright Gonzalo Brito Gadeschi 2014
+// Use, modification and distribution are subject to the Boost Software License,
+// Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt).
+
+/// \file \brief Array of structs of arrays (AoSoA) layout of a column_arena
+
+#if !defined(SCATTERED_DETAIL_TILED_LAYOUT_HPP)
+#define SCATTERED_DETAIL_TILED_LAYOUT_HPP
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include "columns.hpp"
+
+namespace scattered {
+
+namespace detail {
+
+/// \brief RandomAccessIterator over a column of a tiled buffer
+///
+/// The column is stored in chunks of TileSize elements, one per tile, and the
+/// tiles are TileBytes apart.
+template <class V, std::size_t TileSize, std::size_t TileBytes>
+class tiled_column_iterator {
+ public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = std::remove_const_t<V>;
+  using difference_type = std::ptrdiff_t;
+  using reference = V&;
+  using pointer = V*;
+  using byte_pointer
+      = std::conditional_t<std::is_const<V>::value, const char*, char*>;
+  using This = tiled_column_iterator<V, TileSize, TileBytes>;
+
+  [[gnu::always_inline, gnu::hot]] inline
+  tiled_column_iterator() = default;
+  [[gnu::always_inline, gnu::hot]] inline
+  tiled_column_iterator(byte_pointer first, const difference_type i) noexcept
+      : first_(first),
+        i_(i) {}
+  /// \brief iterator -> const_iterator
+  template <class U, std::enable_if_t<std::is_same<const U, V>::value
+                                      && !std::is_same<U, V>::value,
+                                      int> = 0>
+  [[gnu::always_inline, gnu::hot]] inline
+  tiled_column_iterator(
+      const tiled_column_iterator<U, TileSize, TileBytes>& other) noexcept
+      : first_(other.base()),
+        i_(other.index()) {}
+
+  /// \brief Address of the element i of the column starting at first
+  [[gnu::always_inline, gnu::hot, gnu::const, gnu::flatten]] static inline
+  pointer address(byte_pointer first, const std::size_t i) noexcept {
+    return reinterpret_cast<pointer>(first + i / TileSize * TileBytes)
+           + i % TileSize;
+  }
+
+  /// \name Access operators
+  ///@{
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  reference operator*() const noexcept { return *address(first_, i_); }
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  pointer operator->() const noexcept { return address(first_, i_); }
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  reference operator[](const difference_type n) const noexcept {
+    return *address(first_, i_ + n);
+  }
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  byte_pointer base() const noexcept { return first_; }
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  difference_type index() const noexcept { return i_; }
+  ///@}
+
+  /// \name Traversal operators (++, +=, +, --, -=, -)
+  ///@{
+  [[gnu::always_inline, gnu::hot]] inline This& operator++() noexcept {
+    ++i_;
+    return *this;
+  }
+  [[gnu::always_inline, gnu::hot]] inline This operator++(int) noexcept {
+    const auto it = *this;
+    ++i_;
+    return it;
+  }
+  [[gnu::always_inline, gnu::hot]] inline This& operator--() noexcept {
+    --i_;
+    return *this;
+  }
+  [[gnu::always_inline, gnu::hot]] inline This operator--(int) noexcept {
+    const auto it = *this;
+    --i_;
+    return it;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  This& operator+=(const difference_type n) noexcept {
+    i_ += n;
+    return *this;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  This& operator-=(const difference_type n) noexcept {
+    i_ -= n;
+    return *this;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  friend This operator+(This a, const difference_type n) noexcept {
+    return a += n;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  friend This operator+(const difference_type n, This a) noexcept {
+    return a += n;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  friend This operator-(This a, const difference_type n) noexcept {
+    return a -= n;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  friend difference_type operator-(const This& l, const This& r) noexcept {
+    return l.i_ - r.i_;
+  }
+  ///@}
+
+  /// \name Comparison operators (==, !=, <, >, <=, >=)
+  ///@{
+  [[gnu::always_inline, gnu::hot]] inline
+  friend bool operator==(const This& l, const This& r) noexcept {
+    return l.i_ == r.i_;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  friend bool operator!=(const This& l, const This& r) noexcept {
+    return l.i_ != r.i_;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  friend bool operator<(const This& l, const This& r) noexcept {
+    return l.i_ < r.i_;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  friend bool operator>(const This& l, const This& r) noexcept {
+    return l.i_ > r.i_;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  friend bool operator<=(const This& l, const This& r) noexcept {
+    return l.i_ <= r.i_;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  friend bool operator>=(const This& l, const This& r) noexcept {
+    return l.i_ >= r.i_;
+  }
+  ///@}
+
+ private:
+  byte_pointer first_ = nullptr;  ///< First element of the column
+  difference_type i_ = 0;         ///< Element index
+};
+
+/// \brief Non-owning view of a column of a tiled buffer
+template <class V, std::size_t TileSize, std::size_t TileBytes>
+struct tiled_column_view {
+  using value_type = std::remove_const_t<V>;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = V&;
+  using const_reference = V const&;
+  using iterator = tiled_column_iterator<V, TileSize, TileBytes>;
+  using const_iterator = tiled_column_iterator<const V, TileSize, TileBytes>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  iterator begin() const noexcept { return first_; }
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  iterator end() const noexcept { return first_ + size_; }
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  const_iterator cbegin() const noexcept { return first_; }
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  const_iterator cend() const noexcept { return first_ + size_; }
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  size_type size() const noexcept { return size_; }
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  bool empty() const noexcept { return size_ == 0; }
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  reference operator[](const size_type i) const noexcept { return first_[i]; }
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  reference front() const noexcept { return first_[0]; }
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  reference back() const noexcept { return first_[size_ - 1]; }
+
+  iterator first_;
+  size_type size_;
+};
+
+/// \brief Layout of a column_arena: the buffer is split in tiles of TileSize
+/// rows, and each tile stores TileSize elements of every column one after
+/// the other (see contiguous_layout for the Layout interface)
+///
+/// The capacity is a multiple of TileSize, and the offset of a column inside
+/// a tile does not depend on the capacity.
+template <class Columns, std::size_t TileSize> struct tiled_layout;
+
+template <class... Cs, std::size_t TileSize>
+struct tiled_layout<column_list<Cs...>, TileSize> {
+  static_assert(TileSize != 0 && (TileSize & (TileSize - 1)) == 0,
+                "the tile size must be a power of two");
+
+  using size_type = std::size_t;
+  static const constexpr std::size_t no_columns = sizeof...(Cs);
+  static const constexpr std::size_t tile_size = TileSize;
+
+  /// \brief Offset in bytes of the column c inside a tile (c == no_columns is
+  /// the size of a tile)
+  static constexpr size_type tile_offset(const size_type c) noexcept {
+    constexpr size_type sizes[] = {sizeof(typename Cs::value_type)...};
+    constexpr size_type alignments[] = {alignof(typename Cs::value_type)...};
+    size_type offset = 0;
+    size_type alignment = 1;
+    for (size_type i = 0; i != c; ++i) {
+      offset = (offset + alignments[i] - 1) / alignments[i] * alignments[i];
+      offset += TileSize * sizes[i];
+      alignment = alignments[i] > alignment ? alignments[i] : alignment;
+    }
+    const auto a = c == no_columns ? alignment : alignments[c];
+    return (offset + a - 1) / a * a;
+  }
+
+  /// Size in bytes of a tile
+  static const constexpr std::size_t tile_bytes = tile_offset(no_columns);
+
+  template <class V>
+  using iterator = tiled_column_iterator<V, TileSize, tile_bytes>;
+  template <class V>
+  using column_type = tiled_column_view<V, TileSize, tile_bytes>;
+
+  static constexpr size_type capacity(const size_type n) noexcept {
+    return (n + TileSize - 1) / TileSize * TileSize;
+  }
+
+  static std::array<size_type, no_columns> offsets(const size_type) noexcept {
+    std::array<size_type, no_columns> result;
+    for (size_type i = 0; i != no_columns; ++i) { result[i] = tile_offset(i); }
+    return result;
+  }
+
+  static constexpr size_type bytes(const size_type n) noexcept {
+    return capacity(n) / TileSize * tile_bytes;
+  }
+
+  static size_type max_size(const size_type max_bytes) noexcept {
+    return max_bytes / tile_bytes * TileSize;
+  }
+
+  template <class V> static iterator<V> make_iterator(char* p) noexcept {
+    return {p, 0};
+  }
+};
+
+}  // namespace detail
+
+}  // namespace scattered
+
+#endif  // SCATTERED_DETAIL_TILED_LAYOUT_HPP
@@ -0,0 +1,245 @@
+// (C) Copyright Gonzalo Brito Gadeschi 2014
+// Use, modification and distribution are subject to the Boost Software License,
+// Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt).
+
+/// \file \brief Implements the tiled (AoSoA) scattered vector
+
+#if !defined(SCATTERED_DETAIL_TILED_VECTOR_HPP)
+#define SCATTERED_DETAIL_TILED_VECTOR_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include "column_arena.hpp"
+#include "tiled_layout.hpp"
+#include "vector.hpp"
+
+namespace scattered {
+
+/// \brief Storage policy: all columns are stored in a single allocation as
+/// an array of tiles of TileSize rows, each tile storing the TileSize
+/// elements of every column contiguously (AoSoA)
+///
+/// A row that accesses several columns reads them from the same tile, which
+/// needs fewer TLB entries and prefetcher streams than one independent array
+/// per column.
+template <std::size_t TileSize = 64, class Allocator = std::allocator<char>>
+struct tiled_storage {
+  template <class Columns>
+  using storage_type = detail::column_arena
+      <Columns, detail::tiled_layout<Columns, TileSize>, Allocator>;
+};
+
+/// \brief Scattered vector with an AoSoA layout of tiles of TileSize rows
+///
+/// Its interface is that of scattered::vector. The function tiles(v) returns
+/// a range over the tiles of the vector.
+template <class T, std::size_t TileSize = 64,
+          class Allocator = std::allocator<char>>
+using tiled_vector = vector<T, tiled_storage<TileSize, Allocator>>;
+
+namespace detail {
+
+/// \brief Proxy to the tile t of a tiled storage: rows
+/// [t * tile_size, t * tile_size + size())
+///
+/// get<K>(tile) returns a pointer to the tile_size contiguous elements of
+/// the column K in the tile. Loops over a full tile have a compile-time trip
+/// count and can be fully vectorized.
+template <bool is_const_, class Storage> class tile {
+ public:
+  static const constexpr bool is_const = is_const_;
+  static const constexpr std::size_t tile_size
+      = Storage::layout_type::tile_size;
+  using storage_type = std::conditional_t<is_const, const Storage, Storage>;
+  using size_type = std::size_t;
+
+  [[gnu::always_inline, gnu::hot]] inline
+  tile(storage_type* s, const size_type t) noexcept : s_(s), t_(t) {}
+
+  /// \brief Pointer to the first element of the column K in the tile
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  auto get() const noexcept {
+    return std::addressof(s_->template begin<K>()[t_ * tile_size]);
+  }
+  /// \brief Number of rows in the tile (tile_size except for the last tile)
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  size_type size() const noexcept {
+    const size_type rows = s_->size() - t_ * tile_size;
+    return rows < tile_size ? rows : tile_size;
+  }
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  bool full() const noexcept { return size() == tile_size; }
+  /// \brief Index of the tile
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  size_type index() const noexcept { return t_; }
+  /// \brief Index of the first row of the tile
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  size_type first_row() const noexcept { return t_ * tile_size; }
+
+ private:
+  storage_type* s_;
+  size_type t_;
+};
+
+/// \brief RandomAccessIterator over the tiles of a tiled storage
+template <bool is_const_, class Storage> class tile_iterator {
+ public:
+  static const constexpr bool is_const = is_const_;
+  using storage_type = std::conditional_t<is_const, const Storage, Storage>;
+  using This = tile_iterator<is_const, Storage>;
+  using iterator_category = std::random_access_iterator_tag;
+  using difference_type = std::ptrdiff_t;
+  using value_type = tile<is_const, Storage>;
+  using reference = value_type;
+  using pointer = void;
+
+  [[gnu::always_inline, gnu::hot]] inline tile_iterator() = default;
+  [[gnu::always_inline, gnu::hot]] inline
+  tile_iterator(storage_type* s, const difference_type t) noexcept : s_(s),
+                                                                    t_(t) {}
+
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  reference operator*() const noexcept { return {s_, std::size_t(t_)}; }
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  reference operator[](const difference_type n) const noexcept {
+    return {s_, std::size_t(t_ + n)};
+  }
+
+  [[gnu::always_inline, gnu::hot]] inline This& operator++() noexcept {
+    ++t_;
+    return *this;
+  }
+  [[gnu::always_inline, gnu::hot]] inline This operator++(int) noexcept {
+    const auto it = *this;
+    ++t_;
+    return it;
+  }
+  [[gnu::always_inline, gnu::hot]] inline This& operator--() noexcept {
+    --t_;
+    return *this;
+  }
+  [[gnu::always_inline, gnu::hot]] inline This operator--(int) noexcept {
+    const auto it = *this;
+    --t_;
+    return it;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  This& operator+=(const difference_type n) noexcept {
+    t_ += n;
+    return *this;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  This& operator-=(const difference_type n) noexcept {
+    t_ -= n;
+    return *this;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  friend This operator+(This a, const difference_type n) noexcept {
+    return a += n;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  friend This operator+(const difference_type n, This a) noexcept {
+    return a += n;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  friend This operator-(This a, const difference_type n) noexcept {
+    return a -= n;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  friend difference_type operator-(const This& l, const This& r) noexcept {
+    return l.t_ - r.t_;
+  }
+
+  [[gnu::always_inline, gnu::hot]] inline
+  friend bool operator==(const This& l, const This& r) noexcept {
+    return l.t_ == r.t_;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  friend bool operator!=(const This& l, const This& r) noexcept {
+    return l.t_ != r.t_;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  friend bool operator<(const This& l, const This& r) noexcept {
+    return l.t_ < r.t_;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  friend bool operator>(const This& l, const This& r) noexcept {
+    return l.t_ > r.t_;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  friend bool operator<=(const This& l, const This& r) noexcept {
+    return l.t_ <= r.t_;
+  }
+  [[gnu::always_inline, gnu::hot]] inline
+  friend bool operator>=(const This& l, const This& r) noexcept {
+    return l.t_ >= r.t_;
+  }
+
+ private:
+  storage_type* s_ = nullptr;
+  difference_type t_ = 0;
+};
+
+/// \brief Range of the tiles of a tiled storage
+template <bool is_const, class Storage> struct tile_range {
+  using iterator = tile_iterator<is_const, Storage>;
+  using storage_type = typename iterator::storage_type;
+  using size_type = std::size_t;
+  static const constexpr std::size_t tile_size
+      = Storage::layout_type::tile_size;
+
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  iterator begin() const noexcept { return {s_, 0}; }
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  iterator end() const noexcept {
+    return {s_, std::ptrdiff_t(size())};
+  }
+  /// \brief Number of tiles
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  size_type size() const noexcept {
+    return (s_->size() + tile_size - 1) / tile_size;
+  }
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  bool empty() const noexcept { return size() == 0; }
+  [[gnu::always_inline, gnu::hot, gnu::pure]] inline
+  tile<is_const, Storage> operator[](const size_type t) const noexcept {
+    return {s_, t};
+  }
+
+  storage_type* s_;
+};
+
+}  // namespace detail
+
+/// \brief Range over the tiles of the tiled vector v
+///
+/// Typical use:
+/// \code
+/// for (auto t : tiles(v)) {
+///   auto x = get<k::x>(t);
+///   auto y = get<k::y>(t);
+///   for (std::size_t i = 0; i != t.size(); ++i) { x[i] += y[i]; }
+/// }
+/// \endcode
+template <class T, std::size_t TileSize, class Allocator>
+[[gnu::always_inline, gnu::hot, gnu::pure]] inline
+auto tiles(tiled_vector<T, TileSize, Allocator>& v) noexcept {
+  using storage_type =
+      typename tiled_vector<T, TileSize, Allocator>::storage_type;
+  return detail::tile_range<false, storage_type>{&v.storage()};
+}
+template <class T, std::size_t TileSize, class Allocator>
+[[gnu::always_inline, gnu::hot, gnu::pure]] inline
+auto tiles(const tiled_vector<T, TileSize, Allocator>& v) noexcept {
+  using storage_type =
+      typename tiled_vector<T, TileSize, Allocator>::storage_type;
+  return detail::tile_range<true, storage_type>{&v.storage()};
+}
+
+}  // namespace scattered
+
+#endif  // SCATTERED_DETAIL_TILED_VECTOR_HPP
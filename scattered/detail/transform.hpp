@@ -0,0 +1,205 @@
+// (C) Copyright Gonzalo Brito Gadeschi 2014
+// Use, modification and distribution are subject to the Boost Software License,
+// Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt).
+
+/// \file \brief Vectorizable kernels over the columns of a scattered vector
+
+#if !defined(SCATTERED_DETAIL_TRANSFORM_HPP)
+#define SCATTERED_DETAIL_TRANSFORM_HPP
+
+#include <cstddef>
+#include <type_traits>
+#include "columns.hpp"
+#include "isa.hpp"
+#include "vector.hpp"
+
+namespace scattered {
+
+namespace detail {
+
+/// \brief Pointer to the elements of the column K of the storage s, if its
+/// column container is contiguous (i.e. provides data()), and nullptr
+/// otherwise (e.g. for packed bool columns or tiled storage)
+template <class K, class S,
+          class V = column_value_t<K, typename std::decay_t<S>::columns>>
+auto column_pointer(S& s, int) -> std::enable_if_t<
+    std::is_same<std::remove_cv_t<std::remove_pointer_t<decltype(
+                     s.template column<K>().data())>>,
+                 V>::value,
+    decltype(s.template column<K>().data())> {
+  return s.template column<K>().data();
+}
+template <class K, class S> std::nullptr_t column_pointer(S&, long) {
+  return nullptr;
+}
+
+/// \brief Are all the columns Ks of the storage S contiguous
+template <class S, class... Ks> constexpr bool contiguous_columns() {
+  const bool contiguous[] = {
+      true, std::is_pointer<decltype(
+                column_pointer<Ks>(std::declval<const S&>(), 0))>::value...};
+  for (bool c : contiguous) {
+    if (!c) { return false; }
+  }
+  return true;
+}
+
+/// \brief Input column that is the output column of a transform
+struct output_column {};
+
+template <class Out, class In>
+[[gnu::always_inline, gnu::hot, gnu::pure]] inline
+const In& element(const In* in, const Out*, const std::size_t i) noexcept {
+  return in[i];
+}
+template <class Out>
+[[gnu::always_inline, gnu::hot, gnu::pure]] inline
+const Out& element(output_column, const Out* out,
+                   const std::size_t i) noexcept {
+  return out[i];
+}
+
+/// \brief out[i] = f(in[i]...) for i in [0, n)
+///
+/// Since out is restrict-qualified, the compiler knows that the writes do
+/// not alias the reads and vectorizes the loop without run-time overlap
+/// checks. An input that is the output column is read through out.
+template <class Out, class F, class... Ins>
+[[gnu::always_inline, gnu::hot]] inline
+void transform_loop(const std::size_t n, Out* __restrict out, F& f,
+                    const Ins... in) {
+  for (std::size_t i = 0; i != n; ++i) {
+    out[i] = static_cast<Out>(f(element(in, out, i)...));
+  }
+}
+SCATTERED_MULTIVERSIONED(transform_kernel, transform_loop);
+
+/// \brief *out++ = f(*in++...) n times
+template <class V, class Out, class F, class... Ins>
+void transform_iterators(const std::size_t n, Out out, F& f, Ins... in) {
+  for (std::size_t i = 0; i != n; ++i, ++out) {
+    *out = static_cast<V>(f(*in++...));
+  }
+}
+
+template <class Kout, class Kin, class S,
+          std::enable_if_t<!std::is_same<Kout, Kin>::value, int> = 0>
+[[gnu::always_inline]] inline auto input_pointer(S& s) {
+  return column_pointer<Kin>(static_cast<const S&>(s), 0);
+}
+template <class Kout, class Kin, class S,
+          std::enable_if_t<std::is_same<Kout, Kin>::value, int> = 0>
+[[gnu::always_inline]] inline output_column input_pointer(S&) {
+  return {};
+}
+
+template <class Kout, class... Kin, class S, class F>
+void transform_columns(std::true_type, S& s, F& f) {
+  transform_kernel::call(s.size(), column_pointer<Kout>(s, 0), f,
+                         input_pointer<Kout, Kin>(s)...);
+}
+template <class Kout, class... Kin, class S, class F>
+void transform_columns(std::false_type, S& s, F& f) {
+  using V = column_value_t<Kout, typename S::columns>;
+  const auto& cs = s;
+  transform_iterators<V>(s.size(), s.template begin<Kout>(), f,
+                         cs.template begin<Kin>()...);
+}
+
+/// \brief Number of independent partial results of reduce
+static const constexpr std::size_t reduce_lanes = 16;
+
+/// \brief Folds in[0, n) into init with op, keeping reduce_lanes partial
+/// results so that the loop vectorizes without reassociating op
+template <class T, class V, class Op>
+[[gnu::always_inline, gnu::hot]] inline
+T reduce_loop(const std::size_t n, const V* __restrict in, T init, Op& op) {
+  std::size_t i = 0;
+  if (n >= reduce_lanes) {
+    T acc[reduce_lanes];
+    for (std::size_t j = 0; j != reduce_lanes; ++j) { acc[j] = in[j]; }
+    for (i = reduce_lanes; i + reduce_lanes <= n; i += reduce_lanes) {
+      for (std::size_t j = 0; j != reduce_lanes; ++j) {
+        acc[j] = op(acc[j], in[i + j]);
+      }
+    }
+    for (std::size_t j = 0; j != reduce_lanes; ++j) {
+      init = op(init, acc[j]);
+    }
+  }
+  for (; i != n; ++i) { init = op(init, in[i]); }
+  return init;
+}
+SCATTERED_MULTIVERSIONED(reduce_kernel, reduce_loop);
+
+template <class T, class It, class Op>
+T reduce_iterators(const std::size_t n, It in, T init, Op& op) {
+  for (std::size_t i = 0; i != n; ++i, ++in) { init = op(init, *in); }
+  return init;
+}
+
+/// \brief Reduces the column K with reduce_kernel if it is contiguous and
+/// both its values and the result are arithmetic types
+template <class K, class S, class T, class Op>
+T reduce_column(std::true_type, const S& s, T init, Op& op) {
+  return reduce_kernel::call(s.size(), column_pointer<K>(s, 0), init, op);
+}
+template <class K, class S, class T, class Op>
+T reduce_column(std::false_type, const S& s, T init, Op& op) {
+  return reduce_iterators(s.size(), s.template begin<K>(), init, op);
+}
+
+}  // namespace detail
+
+/// \name Column kernels
+///
+/// The kernels run over the raw pointers of the columns when the storage is
+/// contiguous (e.g. container_storage, arena_storage, and the small, static,
+/// and reserved vectors), where the loops vectorize, and over the column
+/// iterators otherwise (e.g. packed bool columns, tiled and grouped
+/// storage). The loops over raw pointers are compiled for several
+/// instruction sets, and the variant of selected_isa() runs (see isa.hpp).
+///@{
+/// \brief Sets get<Kout>(v, i) = f(get<Kin>(v, i)...) for every row i
+///
+/// The result of f is converted to the type of the column Kout, so the
+/// columns can have different types, e.g. a float column computed from two
+/// double columns:
+///
+///   transform<k::x>(v, [](double a, double b) { return a * b; }, k::a{},
+///                   k::b{});
+///
+/// Kout can be one of the input columns, e.g. to square a column in place:
+///
+///   transform<k::x>(v, [](auto x) { return x * x; }, k::x{});
+template <class Kout, class T, class S, class F, class... Kin>
+void transform(vector<T, S>& v, F&& f, Kin...) {
+  using storage_type = typename vector<T, S>::storage_type;
+  using contiguous = std::integral_constant
+      <bool, detail::contiguous_columns<storage_type, Kout, Kin...>()>;
+  detail::transform_columns<Kout, Kin...>(contiguous{}, v.storage(), f);
+}
+
+/// \brief Folds the column K of v into init with op
+///
+/// The order in which the elements are combined is unspecified, so op should
+/// be associative and commutative (as for std::reduce). The partial results
+/// have the type of init, e.g. to sum a float column in double precision:
+///
+///   double sum = reduce<k::x>(v, 0., std::plus<>{});
+template <class K, class T, class S, class Init, class Op>
+Init reduce(const vector<T, S>& v, Init init, Op op) {
+  using storage_type = typename vector<T, S>::storage_type;
+  using V = detail::column_value_t<K, typename storage_type::columns>;
+  using vectorizable = std::integral_constant
+      <bool, detail::contiguous_columns<storage_type, K>()
+                 && std::is_arithmetic<V>::value
+                 && std::is_arithmetic<Init>::value>;
+  return detail::reduce_column<K>(vectorizable{}, v.storage(), init, op);
+}
+///@}
+
+}  // namespace scattered
+
+#endif  // SCATTERED_DETAIL_TRANSFORM_HPP
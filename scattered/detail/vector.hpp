@@ -8,70 +8,51 @@
 #if !defined(SCATTERED_DETAIL_VECTOR_HPP)
 #define SCATTERED_DETAIL_VECTOR_HPP
 
+#include <algorithm>
+#include <functional>
 #include <stdexcept>
+#include <string>
 #include <type_traits>
-#include <boost/container/vector.hpp>
-#include <boost/fusion/adapted/mpl.hpp>
-#include <boost/mpl/transform.hpp>
-#include <boost/fusion/support/pair.hpp>
+#include <utility>
+#include <vector>
 #include <boost/fusion/sequence/intrinsic/at_key.hpp>
-#include <boost/fusion/algorithm/transformation/transform.hpp>
-#include <boost/fusion/algorithm/iteration/for_each.hpp>
 
-#include "fusion_swap.hpp"
-#include "as_fusion_map.hpp"
+#include "assert.hpp"
+#include "columns.hpp"
+#include "container_storage.hpp"
+#include "column_arena.hpp"
+#include "grouped_storage.hpp"
 #include "vector_iterator_base.hpp"
 #include "get.hpp"
-#include "unqualified.hpp"
 
 namespace scattered {
 
-template <class T>
-using default_vector_container = boost::container::vector<T, std::allocator<T>>;
-
 /// \brief scattered vector
-template <class T, template <class> class Container = default_vector_container>
+///
+/// The columns are stored as specified by the Storage policy, see
+/// container_storage (default) and arena_storage.
+template <class T, class Storage = container_storage<>>
 class vector {
   /// \name Vector utilities
   ///@{
-  /// T as a associative fusion map:
-  using MemberMap = typename detail::as_fusion_map<T>::type;
-  /// P -> P::key_type
-  template <class P> struct key_of {
-    using type = typename detail::unqualified_t<P>::first_type;
-  };
-  template <class P> using key_of_t = typename key_of<P>::type;
-  /// P -> P::value_type
-  template <class P> struct val_of {
-    using type = typename detail::unqualified_t<P>::second_type;
-  };
-  /// T -> (key_of<member0>..key_of<memberN>)
-  using keys = typename boost::mpl::transform
-      <MemberMap, key_of<boost::mpl::_1>>::type;
-  /// T -> (val_of<member0>..val_of<memberN>)
-  using values = typename boost::mpl::transform
-      <MemberMap, val_of<boost::mpl::_1>>::type;
-  /// P<key, val> -> P<key, Container<val>>
-  template <class P> struct container_of {
-    using type = boost::fusion::pair
-        <typename P::first_type, Container<typename P::second_type>>;
-  };
-  /// T -> (Container<T.member0>..Container<T.memberN>)
-  using data_type = typename boost::mpl::transform
-      <MemberMap, container_of<boost::mpl::_1>>::type;
+  /// T -> (column<key0, T.member0>..column<keyN, T.memberN>)
+  using columns = detail::columns_of_t<T>;
   ///@}
 
-  data_type data_;
+ public:
+  using storage_type = typename Storage::template storage_type<columns>;
+
+ private:
+  storage_type storage_;
 
  public:
   /// Container traits
   ///{@
-  template <class U> using container_type = Container<U>;
+  template <class U>
+  using container_type = typename storage_type::template column_type<U>;
   using size_type = std::size_t;
-  using iterator = typename detail::vector_iterator_base
-      <false, values, keys, Container, T>;
-  using const_iterator = typename detail::vector_iterator_base
-      <true, values, keys, Container, T>;
+  using iterator = detail::vector_iterator_base<false, storage_type, T>;
+  using const_iterator = detail::vector_iterator_base<true, storage_type, T>;
   using value_type = typename iterator::value_type;
   using reference = typename iterator::reference;
   using const_reference = typename const_iterator::reference;
@@ -86,77 +67,32 @@ class vector {
   /// Constructors
   ///@{
   explicit vector(size_type n = 0) { resize(n); }
-  vector(const vector& other) : data_(other.data_) {}
-  vector(vector&& other) : data_(std::move(other.data_)) {}
+  vector(const vector& other) : storage_(other.storage_) {}
+  vector(vector&& other) : storage_(std::move(other.storage_)) {}
 
   [[gnu::always_inline, gnu::hot]] inline
-  vector& operator=(const vector& other) { data_(other.data_); }
+  vector& operator=(const vector& other) {
+    storage_ = other.storage_;
+    return *this;
+  }
   [[gnu::always_inline, gnu::hot]] inline
-  vector& operator=(vector&& other) { data_(std::move(other.data_)); }
+  vector& operator=(vector&& other) {
+    storage_ = std::move(other.storage_);
+    return *this;
+  }
   ///@}
 
   /// Iterators
   ///@{
- private:
-  struct make_begin_it {
-    template <class U>
-    [[gnu::always_inline, gnu::hot, gnu::const]] inline
-    auto operator()(U& i) const noexcept {
-      return boost::fusion::make_pair
-          <typename key_of<U>::type>
-          (const_cast<typename val_of<U>::type&>(i.second).begin());
-    }
-  };
-
-  struct make_cbegin_it {
-    template <class U>
-    [[gnu::always_inline, gnu::hot, gnu::const]] inline
-    auto operator()(U& i) const noexcept {
-      using key_type = typename key_of<U>::type;
-      using val_type = typename val_of<U>::type;
-      return boost::fusion::make_pair<key_type>(i.second.cbegin());
-    }
-  };
-
-  struct make_end_it {
-    template <class U>
-     [[gnu::always_inline, gnu::hot, gnu::const]] inline
-    auto operator()(U& i) const noexcept {
-      using key_type = typename key_of<U>::type;
-      using val_type = typename val_of<U>::type;
-      return boost::fusion::make_pair
-          <key_type>(const_cast<val_type&>(i.second).end());
-    }
-  };
-
-  struct make_cend_it {
-    template <class U>
-    [[gnu::always_inline, gnu::hot, gnu::const]] inline
-    auto operator()(U& i) const noexcept {
-      using key_type = typename key_of<U>::type;
-      using val_type = typename val_of<U>::type;
-      return boost::fusion::make_pair<key_type>(i.second.cend());
-    }
-  };
-
- public:
   [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
-  iterator begin() noexcept {
-    return iterator::from_map(boost::fusion::transform(data_, make_begin_it()));
-  }
+  iterator begin() noexcept { return {&storage_, 0}; }
   [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
-  iterator end() noexcept {
-    return iterator::from_map(boost::fusion::transform(data_, make_end_it()));
-  }
+  iterator end() noexcept { return {&storage_, difference_type(size())}; }
   [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
-  const_iterator cbegin() const noexcept {
-    return const_iterator::from_map(
-        boost::fusion::transform(data_, make_cbegin_it()));
-  }
+  const_iterator cbegin() const noexcept { return {&storage_, 0}; }
   [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
   const_iterator cend() const noexcept {
-    return const_iterator::from_map(
-        boost::fusion::transform(data_, make_cend_it()));
+    return {&storage_, difference_type(size())};
   }
   [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
   const_iterator begin() const noexcept { return cbegin(); }
@@ -175,85 +111,69 @@ class vector {
 
   /// Element Access
   ///@{
-  inline constexpr const_reference at(const size_type pos) const noexcept {
-    if (!(pos < size())) {
-      throw std::out_of_range("scattered::vector::at(" + std::to_string(pos)
-                              + ") is out of bounds [0,"
-                              + std::to_string(size()) + ")");
-
-    } else {
-      return (*this)[pos];
-    }
+  [[gnu::always_inline, gnu::hot, gnu::flatten]] inline
+  reference at(const size_type pos) {
+    check_bounds(pos);
+    return (*this)[pos];
+  }
+  [[gnu::always_inline, gnu::hot, gnu::flatten]] inline
+  const_reference at(const size_type pos) const {
+    check_bounds(pos);
+    return (*this)[pos];
   }
+  /// \brief Reference to the row pos (the columns are accessed lazily)
   [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
-  reference operator[](const size_type pos) noexcept { return begin()[pos]; }
+  reference operator[](const size_type pos) noexcept {
+    return {&storage_, pos};
+  }
   [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
   const_reference operator[](const size_type pos) const noexcept {
-    return cbegin()[pos];
+    return {&storage_, pos};
   }
   [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
-  reference front() noexcept { return *begin(); }
+  reference front() noexcept { return (*this)[0]; }
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  const_reference front() const noexcept { return (*this)[0]; }
   [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
-  constexpr const_reference front() const noexcept { return *cbegin(); }
+  reference back() noexcept { return (*this)[size() - 1]; }
   [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
-  reference back() noexcept { return *end(); }
+  const_reference back() const noexcept { return (*this)[size() - 1]; }
+  /// \brief Storage of the columns
   [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
-  constexpr const_reference back() const noexcept { return *cend(); }
+  storage_type& storage() noexcept { return storage_; }
   [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
-  data_type& data() noexcept { return data_; }
+  storage_type const& storage() const noexcept { return storage_; }
+  /// \brief Map of column containers (only for container_storage)
   [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
-  data_type const& data() const noexcept { return data_; }
+  decltype(auto) data() noexcept { return storage_.data(); }
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  decltype(auto) data() const noexcept { return storage_.data(); }
+  /// \brief Column of key K
   template <class K>
   [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
-  auto& data() { return get<K>(data_); }
+  decltype(auto) data() { return storage_.template column<K>(); }
   template <class K>
   [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
-  auto const& data() const { return get<K>(data_); }
+  decltype(auto) data() const { return storage_.template column<K>(); }
   ///@}
 
   /// Capacity
   ///@{
-  inline bool empty() const {
-    return boost::fusion::all(data_, [](auto i) { return i.second.empty(); });
-  }
-  size_type capacity() const {
-    auto cap = boost::fusion::at_c<0>(data_).second.capacity();
-    return cap;
-  }
-  size_type size() const {
-    auto size_ = boost::fusion::at_c<0>(data_).second.size();
-    return size_;
-  }
-  // reserve
-  struct reserve_ {
-    reserve_(std::size_t n) : n_(n) {}
-    template <class U> void operator()(U&& i) const { i.second.reserve(n_); }
-    const std::size_t n_;
-  };
-  void reserve(std::size_t n) {
-    boost::fusion::for_each(data_, [&](auto i) { i.second.reserve(n); });
-  }
-  void shrink_to_fit() {
-    boost::fusion::for_each(data_, [](auto i) { i.second.shrink_to_fit(); });
-  }
-  void max_size() {
-    boost::fusion::for_each(data_, [](auto i) { i.second.max_size(); });
-  }
+  inline bool empty() const { return size() == 0; }
+  size_type capacity() const { return storage_.capacity(); }
+  size_type size() const { return storage_.size(); }
+  void reserve(std::size_t n) { storage_.reserve(n); }
+  void shrink_to_fit() { storage_.shrink_to_fit(); }
+  size_type max_size() const { return storage_.max_size(); }
   ///@}
 
   /// Modifiers
   ///@{
-  void clear() {
-    boost::fusion::for_each(data_, [](auto i) { i.second.clear(); });
-  }
+  void clear() { storage_.clear(); }
   iterator insert(const_iterator pos, const T& value) {
     const auto offset = pos - cbegin();
-    boost::fusion::for_each(boost::fusion::zip(MemberMap{}, value),
-                            [&](auto&& i) {
-      using key = key_of_t<decltype(boost::fusion::at_c<0>(i))>;
-      auto local_pos = get<key>(data_).cbegin() + offset;
-      get<key>(data_).insert(local_pos, boost::fusion::at_c<1>(i));
-    });
+    storage_.insert(offset, 1);
+    begin()[offset] = value;
     return begin() + offset;
   }
   // iterator insert( const_iterator pos, size_type count, const T& value );
@@ -261,10 +181,11 @@ class vector {
   iterator insert(const_iterator pos, InputIt first, InputIt last) {
     const auto offset = pos - cbegin();
     if (first != last) {
-      boost::fusion::for_each(data_, [&](auto&& i) {
-        using key = key_of_t<detail::unqualified_t<decltype(i)>>;
-        auto local_pos = i.second.cbegin() + offset;
-        i.second.insert(local_pos, get<key>(first), get<key>(last));
+      storage_.insert(offset, last - first);
+      detail::for_each_column(columns{}, [&](auto c) {
+        using key = typename decltype(c)::key;
+        std::copy(get<key>(first), get<key>(last),
+                  storage_.template begin<key>() + offset);
       });
     }
     return begin() + offset;
@@ -272,79 +193,91 @@ class vector {
 
   iterator erase(const_iterator pos) {
     const auto offset = pos - cbegin();
-    boost::fusion::for_each(data_, [&](auto&& i) {
-      auto local_pos = i.second.cbegin() + offset;
-      i.second.erase(local_pos);
-    });
+    storage_.erase(offset, 1);
+    return begin() + offset;
   }
   iterator erase(const_iterator first, const_iterator last) {
     const auto first_offset = first - cbegin();
     const auto last_offset = last - cbegin();
-    boost::fusion::for_each(data_, [&](auto&& i) {
-      auto local_first = i.second.cbegin() + first_offset;
-      auto local_last = i.second.cbegin() + last_offset;
-      i.second.erase(first, last);
+    storage_.erase(first_offset, last_offset - first_offset);
+    return begin() + first_offset;
+  }
+  /// \brief Erases the row pos by moving the last row into it
+  ///
+  /// Takes constant time, but does not preserve the order of the rows.
+  iterator unordered_erase(const_iterator pos) {
+    const size_type offset = pos - cbegin();
+    const size_type last = size() - 1;
+    if (offset != last) {
+      detail::for_each_column(columns{}, [&](auto c) {
+        const auto first = storage_.template begin<typename decltype(c)::key>();
+        first[offset] = std::move(first[last]);
+      });
+    }
+    storage_.pop_back();
+    return begin() + offset;
+  }
+  /// \brief Erases the rows with the given indices by moving rows from the
+  /// back of the vector into them
+  ///
+  /// The indices are sorted (and deduplicated) and the holes are filled from
+  /// the highest one, so that no row is moved into a hole that is erased
+  /// later, and each column is traversed once.
+  void unordered_erase(std::vector<size_type> rows) {
+    std::sort(rows.begin(), rows.end(), std::greater<size_type>{});
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+    if (rows.empty()) { return; }
+    ASSERT(rows.front() < size(), "row index out of bounds");
+    detail::for_each_column(columns{}, [&](auto c) {
+      const auto first = storage_.template begin<typename decltype(c)::key>();
+      size_type last = size();
+      for (auto i : rows) {
+        if (i != --last) { first[i] = std::move(first[last]); }
+      }
     });
+    storage_.resize(size() - rows.size());
   }
   void push_back(const T& value) {
-    boost::fusion::for_each(boost::fusion::zip(MemberMap{}, value),
-                            [&](auto&& i) {
-      using key = key_of_t<decltype(boost::fusion::at_c<0>(i))>;
-      get<key>(data_).push_back(boost::fusion::at_c<1>(i));
+    storage_.emplace_back([&](auto c) -> decltype(auto) {
+      return get<typename decltype(c)::key>(value);
     });
   };
   void push_back(T&& value) {
-    boost::fusion::for_each(boost::fusion::zip(MemberMap{}, value),
-                            [&](auto&& i) {
-      using key = key_of_t<decltype(boost::fusion::at_c<0>(i))>;
-      get<key>(data_).emplace_back(boost::fusion::at_c<1>(std::move(i)));
-    });
-  };
-  void push_back(const value_type& value) {
-    boost::fusion::for_each(value, [&](auto&& i) {
-      using key = key_of_t<decltype(i)>;
-      get<key>(data_).push_back(i.second);
-    });
-  };
-  void push_back(value_type&& value) {
-    boost::fusion::for_each(std::move(value), [&](auto&& i) {
-      using key = key_of_t<decltype(i)>;
-      get<key>(data_).emplace_back(std::move(i.second));
+    storage_.emplace_back([&](auto c) -> decltype(auto) {
+      return std::move(get<typename decltype(c)::key>(value));
     });
   };
-  void pop_back() {
-    boost::fusion::for_each(data_, [&](auto&& i) { i.second.pop_back(); });
-  }
-  void resize(std::size_t n) {
-    boost::fusion::for_each(data_, [&](auto&& i) { i.second.resize(n); });
-  }
+  void pop_back() { storage_.pop_back(); }
+  void resize(std::size_t n) { storage_.resize(n); }
   ///@}
 
   /// Non-member functions
   ///@{
-  inline friend void swap(vector&& a, vector&& b) noexcept {
-    data_type tmp = std::move(a.data_);
-    a.data_ = std::move(b.data_);
-    b.data_ = std::move(tmp);
+  inline friend void swap(vector& a, vector& b) noexcept(
+      noexcept(swap(std::declval<storage_type&>(),
+                    std::declval<storage_type&>()))) {
+    swap(a.storage_, b.storage_);
   }
 
   inline friend bool operator==(const vector& lhs, const vector& rhs) noexcept {
-    return boost::fusion::all(boost::fusion::zip(lhs.data_, rhs.data_),
-                              [](auto&& i) {
-      return boost::fusion::at_c<0>(i) == boost::fusion::at_c<1>(i);
-    });
+    return lhs.size() == rhs.size()
+           && detail::all_columns(columns{}, [&](auto c) {
+                using key = typename decltype(c)::key;
+                return std::equal(lhs.storage_.template begin<key>(),
+                                  lhs.storage_.template end<key>(),
+                                  rhs.storage_.template begin<key>());
+              });
   }
   inline friend bool operator<=(const vector& lhs, const vector& rhs) noexcept {
-    return boost::fusion::all(boost::fusion::zip(lhs.data_, rhs.data_),
-                              [](auto&& i) {
-      return boost::fusion::at_c<0>(i) <= boost::fusion::at_c<1>(i);
+    return detail::all_columns(columns{}, [&](auto c) {
+      using key = typename decltype(c)::key;
+      return !std::lexicographical_compare(
+          rhs.storage_.template begin<key>(), rhs.storage_.template end<key>(),
+          lhs.storage_.template begin<key>(), lhs.storage_.template end<key>());
     });
   }
   inline friend bool operator>=(const vector& lhs, const vector& rhs) noexcept {
-    return boost::fusion::all(boost::fusion::zip(lhs.data_, rhs.data_),
-                              [](auto&& i) {
-      return boost::fusion::at_c<0>(i) >= boost::fusion::at_c<1>(i);
-    });
+    return rhs <= lhs;
   }
 
   inline friend bool operator!=(const vector& lhs, const vector& rhs) noexcept {
@@ -359,27 +292,13 @@ class vector {
   ///@}
 
   [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] static inline
-  T to_type(reference ref) {
-    T tmp;
-    boost::fusion::for_each(ref, [&](auto&& i) {
-      using key = key_of_t<decltype(i)>;
-      get<key>(tmp) = i.second;
-    });
-    return tmp;
-  }
+  T to_type(reference ref) { return ref; }
   [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] static inline
   T& to_type(T& t) { return t; }
   [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] static inline
   T to_type(T&& t) { return t; }
   [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] static inline
-  T to_type(const_reference ref) {
-    T tmp;
-    boost::fusion::for_each(ref, [&](auto&& i) {
-      using key = key_of_t<decltype(i)>;
-      get<key>(tmp) = i.second;
-    });
-    return tmp;
-  }
+  T to_type(const_reference ref) { return ref; }
   [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] static inline
   value_type& from_type(value_type& value) { return value; }
   [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] static inline
@@ -388,18 +307,31 @@ class vector {
   reference from_type(reference&& value) { return value; }
   [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] static inline
   reference& from_type(reference& value) { return value; }
-  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] static inline
-  value_type from_type(T& value) {
-    value_type tmp;
-    boost::fusion::for_each(boost::fusion::zip(MemberMap{}, value),
-                            [&](auto&& i) {
-      using key = key_of_t<decltype(boost::fusion::at_c<0>(i))>;
-      get<key>(tmp) = boost::fusion::at_c<1>(i);
-    });
-    return tmp;
+
+ private:
+  inline void check_bounds(const size_type pos) const {
+    if (!(pos < size())) {
+      throw std::out_of_range("scattered::vector::at(" + std::to_string(pos)
+                              + ") is out of bounds [0,"
+                              + std::to_string(size()) + ")");
+    }
   }
 };
 
+/// \brief Element of the column K at row i of the vector v
+///
+/// Only the column K is accessed.
+template <class K, class T, class S>
+[[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+decltype(auto) get(vector<T, S>& v, const std::size_t i) noexcept {
+  return v.storage().template at<K>(i);
+}
+template <class K, class T, class S>
+[[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+decltype(auto) get(const vector<T, S>& v, const std::size_t i) noexcept {
+  return v.storage().template at<K>(i);
+}
+
 }  // namespace scattered
 
 #endif  // SCATTERED_DETAIL_VECTOR_HPP
@@ -0,0 +1,205 @@
+// (C) Copyright Gonzalo Brito Gadeschi 2014
+// Use, modification and distribution are subject to the Boost Software License,
+// Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt).
+
+/// \file \brief Reference proxy to a row of a scattered container
+
+#if !defined(SCATTERED_DETAIL_VECTOR_REFERENCE_HPP)
+#define SCATTERED_DETAIL_VECTOR_REFERENCE_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <boost/fusion/sequence/intrinsic/at_key.hpp>
+#include "columns.hpp"
+
+namespace scattered {
+
+namespace detail {
+
+/// \brief Equality of column values (floating point values are compared
+/// up to the machine epsilon, proxies like bit_reference are compared with
+/// their value)
+template <class T, class U,
+          std::enable_if_t<!std::is_floating_point<T>::value, int> = 0>
+[[gnu::always_inline, gnu::hot, gnu::const, gnu::flatten]] inline
+bool column_equal(const T& a, const U& b) noexcept {
+  return a == b;
+}
+template <class T, std::enable_if_t<std::is_floating_point<T>::value, int> = 0>
+[[gnu::always_inline, gnu::hot, gnu::const, gnu::flatten]] inline
+bool column_equal(const T& a, const T& b) noexcept {
+  return std::abs(a - b) < std::numeric_limits<T>::epsilon();
+}
+
+/// \brief Reference proxy to the row i of a scattered container
+///
+/// It stores a pointer to the column storage and the row index only. The
+/// address of a column is computed when it is accessed with get<K>, so
+/// accessing one column of a row does not touch the other columns.
+///
+/// Copying the proxy rebinds it, assigning to it assigns the columns of the
+/// row it refers to.
+///
+/// Only the Columns of the row are assigned, swapped, compared, and copied
+/// into a value (the other members of the value are value-initialized), see
+/// view.
+template <bool is_const_, class Storage, class T,
+          class Columns = typename Storage::columns>
+class vector_reference {
+ public:
+  static const constexpr bool is_const = is_const_;
+  using storage_type = std::conditional_t<is_const, const Storage, Storage>;
+  using columns = Columns;
+  template <bool c> using with_const = vector_reference<c, Storage, T, Columns>;
+  using size_type = std::size_t;
+  using value_type = T;
+  using scattered = bool;
+
+  /// \name Constructors
+  ///@{
+  [[gnu::hot, gnu::always_inline, gnu::flatten]] inline
+  vector_reference(storage_type* s, const size_type i) noexcept : s_(s),
+                                                                  i_(i) {}
+  [[gnu::hot, gnu::always_inline, gnu::flatten]] inline
+  vector_reference(const vector_reference& other) noexcept = default;
+  /// \brief Reference -> const reference
+  template <bool c = is_const, std::enable_if_t<c, int> = 0>
+  [[gnu::hot, gnu::always_inline, gnu::flatten]] inline
+  vector_reference(const with_const<false>& other) noexcept
+      : s_(other.storage()),
+        i_(other.index()) {}
+  ///@}
+
+  /// \name Assignment (assigns the columns of the referred row)
+  ///@{
+  [[gnu::always_inline, gnu::hot, gnu::flatten]] inline
+  vector_reference& operator=(const vector_reference& other) {
+    return assign_(other);
+  }
+  template <bool c>
+  [[gnu::always_inline, gnu::hot, gnu::flatten]] inline
+  vector_reference& operator=(const with_const<c>& other) {
+    return assign_(other);
+  }
+  [[gnu::always_inline, gnu::hot, gnu::flatten]] inline
+  vector_reference& operator=(const value_type& other) {
+    for_each_column(columns{}, [&](auto c) {
+      using K = typename decltype(c)::key;
+      this->get<K>() = boost::fusion::at_key<K>(other);
+    });
+    return *this;
+  }
+  [[gnu::always_inline, gnu::hot, gnu::flatten]] inline
+  vector_reference& operator=(value_type&& other) {
+    for_each_column(columns{}, [&](auto c) {
+      using K = typename decltype(c)::key;
+      this->get<K>() = std::move(boost::fusion::at_key<K>(other));
+    });
+    return *this;
+  }
+  ///@}
+
+  /// \name Access
+  ///@{
+  /// \brief Column K of the row
+  template <class K>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  decltype(auto) get() const noexcept {
+    return s_->template at<K>(i_);
+  }
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  storage_type* storage() const noexcept { return s_; }
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  size_type index() const noexcept { return i_; }
+
+  /// \brief Copies the row into a value
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  operator value_type() const {
+    value_type tmp{};
+    for_each_column(columns{}, [&](auto c) {
+      using K = typename decltype(c)::key;
+      boost::fusion::at_key<K>(tmp) = this->get<K>();
+    });
+    return tmp;
+  }
+  ///@}
+
+  /// \brief Swaps the columns of the rows referred by a and b
+  [[gnu::always_inline, gnu::hot, gnu::flatten]] inline
+  friend void swap(vector_reference a, vector_reference b) {
+    static_assert(!is_const, "cannot swap const references");
+    for_each_column(columns{}, [&](auto c) {
+      using K = typename decltype(c)::key;
+      using std::swap;
+      swap(a.template get<K>(), b.template get<K>());
+    });
+  }
+
+  /// \name Comparison operators (==, !=, <, >, <=, >=) over all columns
+  ///@{
+  template <bool c>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  bool operator==(const with_const<c>& r) const noexcept {
+    return all_columns(columns{}, [&](auto col) {
+      using K = typename decltype(col)::key;
+      return column_equal(this->get<K>(), r.template get<K>());
+    });
+  }
+  template <bool c>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  bool operator<=(const with_const<c>& r) const noexcept {
+    return all_columns(columns{}, [&](auto col) {
+      using K = typename decltype(col)::key;
+      return this->get<K>() <= r.template get<K>();
+    });
+  }
+  template <bool c>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  bool operator>=(const with_const<c>& r) const noexcept {
+    return all_columns(columns{}, [&](auto col) {
+      using K = typename decltype(col)::key;
+      return this->get<K>() >= r.template get<K>();
+    });
+  }
+  template <bool c>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  bool operator!=(const with_const<c>& r) const noexcept {
+    return !(*this == r);
+  }
+  template <bool c>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  bool operator<(const with_const<c>& r) const noexcept {
+    return !(*this >= r);
+  }
+  template <bool c>
+  [[gnu::always_inline, gnu::hot, gnu::pure, gnu::flatten]] inline
+  bool operator>(const with_const<c>& r) const noexcept {
+    return !(*this <= r);
+  }
+  ///@}
+
+ private:
+  storage_type* s_;
+  size_type i_;
+
+  template <class Other>
+  [[gnu::always_inline, gnu::hot, gnu::flatten]] inline
+  vector_reference& assign_(const Other& other) {
+    static_assert(!is_const, "cannot assign to a const reference");
+    for_each_column(columns{}, [&](auto c) {
+      using K = typename decltype(c)::key;
+      this->get<K>() = other.template get<K>();
+    });
+    return *this;
+  }
+};
+
+}  // namespace detail
+
+}  // namespace scattered
+
+#endif  // SCATTERED_DETAIL_VECTOR_REFERENCE_HPP
@@ -0,0 +1,64 @@
+// (C) Copyright Gonzalo Brito Gadeschi 2014
+// Use, modification and distribution are subject to the Boost Software License,
+// Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt).
+
+/// \file \brief Views of a subset of the columns of a scattered vector
+
+#if !defined(SCATTERED_DETAIL_VIEW_HPP)
+#define SCATTERED_DETAIL_VIEW_HPP
+
+#include <cstddef>
+#include <boost/range/iterator_range.hpp>
+#include "columns.hpp"
+#include "vector.hpp"
+
+namespace scattered {
+
+/// \brief Iterator over the columns Ks of the rows of a Storage of T
+///
+/// Its references only assign, swap, compare and copy the columns Ks.
+template <bool is_const, class Storage, class T, class... Ks>
+using view_iterator = detail::vector_iterator_base
+    <is_const, Storage, T,
+     detail::projected_columns<typename Storage::columns, Ks...>>;
+
+/// \brief View of the columns Ks of a vector of T with storage Storage
+template <bool is_const, class Storage, class T, class... Ks>
+using view_type
+    = boost::iterator_range<view_iterator<is_const, Storage, T, Ks...>>;
+
+/// \brief View of the columns Ks of the vector v
+///
+/// The view is a random access range (e.g. for STL and Boost.Range
+/// algorithms) whose elements are proxy references that only access the
+/// columns Ks. For example,
+///
+///   boost::sort(view<k::x, k::y>(v), cmp);
+///
+/// moves the members x and y of the rows of v only, and leaves the other
+/// columns as they are. Converting an element to a value of T copies the
+/// columns Ks and value-initializes the other members. The view is valid while
+/// v is not resized.
+template <class... Ks, class T, class S>
+view_type<false, typename vector<T, S>::storage_type, T, Ks...> view(
+    vector<T, S>& v) noexcept {
+  static_assert(sizeof...(Ks) > 0, "a view needs at least one column");
+  using iterator
+      = view_iterator<false, typename vector<T, S>::storage_type, T, Ks...>;
+  const auto n = static_cast<std::ptrdiff_t>(v.size());
+  return {iterator{&v.storage(), 0}, iterator{&v.storage(), n}};
+}
+template <class... Ks, class T, class S>
+view_type<true, typename vector<T, S>::storage_type, T, Ks...> view(
+    const vector<T, S>& v) noexcept {
+  static_assert(sizeof...(Ks) > 0, "a view needs at least one column");
+  using iterator
+      = view_iterator<true, typename vector<T, S>::storage_type, T, Ks...>;
+  const auto n = static_cast<std::ptrdiff_t>(v.size());
+  return {iterator{&v.storage(), 0}, iterator{&v.storage(), n}};
+}
+
+}  // namespace scattered
+
+#endif  // SCATTERED_DETAIL_VIEW_HPP
@@ -0,0 +1,11 @@
+// (C) Copyright Gonzalo Brito Gadeschi 2014
+// Use, modification and distribution are subject to the Boost Software License,
+// Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt).
+
+#if !defined(SCATTERED_ERASE_HPP)
+#define SCATTERED_ERASE_HPP
+
+#include "detail/erase.hpp"
+
+#endif  // SCATTERED_ERASE_HPP
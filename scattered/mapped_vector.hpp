@@ -0,0 +1,11 @@
+// (C) Copyright Gonzalo Brito Gadeschi 2014
+// Use, modification and distribution are subject to the Boost Software License,
+// Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt).
+
+#if !defined(SCATTERED_MAPPED_VECTOR_HPP)
+#define SCATTERED_MAPPED_VECTOR_HPP
+
+#include "detail/mapped_vector.hpp"
+
+#endif  // SCATTERED_MAPPED_VECTOR_HPP
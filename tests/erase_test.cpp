@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+#include "test_types.hpp"
+#include "scattered/vector.hpp"
+#include "scattered/erase.hpp"
+
+/// \test scattered::erase_if, scattered::erase_mask and unordered_erase tests
+template <class Vector> void test_erase(Vector vec) {
+  using k = TestType::k;
+  using scattered::get;
+
+  const int n = 1000;
+  std::vector<TestType> ref;
+  for (int i = 0; i != n; ++i) {
+    const TestType t{static_cast<float>(i % 7), static_cast<double>(i), i,
+                     (i / 100) % 2 == 0};
+    ref.push_back(t);
+    vec.push_back(t);
+  }
+  auto check = [&](auto&& v) {
+    REQUIRE(v.size() == ref.size());
+    for (std::size_t i = 0; i != ref.size(); ++i) {
+      REQUIRE(get<k::x>(v, i) == Approx(ref[i].x));
+      REQUIRE(get<k::y>(v, i) == Approx(ref[i].y));
+      REQUIRE(get<k::i>(v, i) == ref[i].i);
+      REQUIRE(get<k::b>(v, i) == ref[i].b);
+    }
+  };
+  auto erase_ref = [&](auto pred) {
+    const auto before = ref.size();
+    ref.erase(std::remove_if(ref.begin(), ref.end(), pred), ref.end());
+    return before - ref.size();
+  };
+
+  SECTION("erase_if reads only the predicate columns") {
+    const auto erased = scattered::erase_if<k::i>(vec, [](int i) {
+      return i % 3 == 0;
+    });
+    REQUIRE(erased == erase_ref([](auto t) { return t.i % 3 == 0; }));
+    check(vec);
+    // Runs of whole words are kept or erased at once:
+    REQUIRE(scattered::erase_if<k::b, k::x>(vec, [](bool b, float x) {
+              return b || x == 2.f;
+            }, 3) == erase_ref([](auto t) { return t.b || t.x == 2.f; }));
+    check(vec);
+  }
+  SECTION("erase_mask") {
+    const auto m = scattered::mask<k::b>(vec);
+    REQUIRE(scattered::erase_mask(vec, ~m, 1)
+            == erase_ref([](auto t) { return !t.b; }));
+    check(vec);
+    REQUIRE(scattered::erase_mask(vec, scattered::mask_type(vec.size())) == 0);
+    check(vec);
+    REQUIRE(scattered::erase_mask(vec, ~scattered::mask_type(vec.size()))
+            == ref.size());
+    REQUIRE(vec.empty());
+    REQUIRE(scattered::erase_if<k::i>(vec, [](int) { return true; }) == 0);
+  }
+  SECTION("unordered_erase") {
+    auto it = vec.unordered_erase(vec.begin() + 10);
+    REQUIRE(get<k::i>(*it) == n - 1);
+    ref[10] = ref.back();
+    ref.pop_back();
+    check(vec);
+    vec.unordered_erase(vec.end() - 1);
+    ref.pop_back();
+    check(vec);
+    // Holes near the tail, duplicates and unsorted indices:
+    const std::vector<std::size_t> rows{5, ref.size() - 1, 0, ref.size() - 3,
+                                        5, 100, ref.size() - 2};
+    vec.unordered_erase(rows);
+    REQUIRE(vec.size() == ref.size() - 6);
+    std::vector<int> expected;
+    for (std::size_t i = 0; i != ref.size(); ++i) {
+      if (std::find(rows.begin(), rows.end(), i) == rows.end()) {
+        expected.push_back(ref[i].i);
+      }
+    }
+    std::vector<int> remaining(vec.template data<k::i>().begin(),
+                               vec.template data<k::i>().end());
+    std::sort(remaining.begin(), remaining.end());
+    std::sort(expected.begin(), expected.end());
+    REQUIRE(remaining == expected);
+    for (std::size_t i = 0; i != vec.size(); ++i) {
+      REQUIRE(get<k::y>(vec, i) == Approx(get<k::i>(vec, i)));
+      REQUIRE(get<k::b>(vec, i) == ((get<k::i>(vec, i) / 100) % 2 == 0));
+    }
+    vec.unordered_erase(std::vector<std::size_t>{});
+    REQUIRE(vec.size() == ref.size() - 6);
+  }
+  SECTION("erase of a range of rows") {
+    vec.erase(vec.begin() + 10, vec.begin() + 250);
+    ref.erase(ref.begin() + 10, ref.begin() + 250);
+    check(vec);
+  }
+}
+
+TEST_CASE("Test scattered::erase_if", "[scattered][erase]") {
+  test_erase(scattered::vector<TestType>{});
+}
+
+TEST_CASE("Test scattered::erase_if with arena_storage", "[scattered][erase]") {
+  test_erase(scattered::vector<TestType, scattered::arena_storage<>>{});
+}
@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+#include "test_types.hpp"
+#include "scattered/vector.hpp"
+#include "scattered/executor.hpp"
+#include "scattered/erase.hpp"
+#include "scattered/for_each.hpp"
+#include "scattered/sort.hpp"
+
+/// \test scattered::work_stealing_executor tests
+TEST_CASE("Test scattered::work_stealing_executor",
+          "[scattered][executor]") {
+  using k = TestType::k;
+  using scattered::get;
+  scattered::work_stealing_executor pool(4);
+  REQUIRE(pool.no_threads() == 4);
+
+  SECTION("every row is run once, in chunks aligned to the grain") {
+    const std::size_t n = 100003, grain = 64;
+    std::unique_ptr<std::atomic<int>[]> runs(new std::atomic<int>[n]);
+    for (std::size_t i = 0; i != n; ++i) { runs[i] = 0; }
+    std::atomic<bool> aligned{true};
+    pool.parallel_for(n, grain, [&](std::size_t f, std::size_t l) {
+      if (f % grain != 0 || (l % grain != 0 && l != n)) { aligned = false; }
+      // Uneven costs: the first rows are much more expensive
+      volatile double x = 0;
+      for (std::size_t i = f; i != l; ++i) {
+        ++runs[i];
+        for (std::size_t j = 0; j < (i < 1000 ? 1000 : 1); ++j) { x += j; }
+      }
+    });
+    REQUIRE(aligned);
+    for (std::size_t i = 0; i != n; ++i) { REQUIRE(runs[i] == 1); }
+    pool.parallel_for(0, 1, [](std::size_t, std::size_t) {
+      throw std::runtime_error("empty loops do not run");
+    });
+  }
+  SECTION("exceptions are rethrown after the loop is done") {
+    std::atomic<std::size_t> rows{0};
+    REQUIRE_THROWS_AS(pool.parallel_for(1000, 1, [&](std::size_t f,
+                                                     std::size_t l) {
+      rows += l - f;
+      if (f == 0) { throw std::runtime_error("error"); }
+    }), std::runtime_error);
+    REQUIRE(rows == 1000);
+  }
+  SECTION("nested loops and the parallel algorithms") {
+    const int n = 3000;
+    scattered::vector<TestType> vec;
+    for (int i = 0; i != n; ++i) {
+      vec.push_back({static_cast<float>((i * 7919) % n), 1. * i, i,
+                     i % 2 == 0});
+    }
+    scattered::for_each_column<k::x, k::y>(vec, [&](auto&& c) {
+      pool.parallel_for(c.size(), 8, [&](std::size_t f, std::size_t l) {
+        for (; f != l; ++f) { c[f] *= 2; }
+      });
+    }, pool);
+    REQUIRE(get<k::x>(vec, 1) == Approx(2. * (7919 % n)));
+    REQUIRE(get<k::y>(vec, 10) == Approx(20.));
+    std::atomic<int> count{0};
+    scattered::parallel_for(vec, [&](auto rows) {
+      for (auto&& r : rows) { count += get<k::b>(r); }
+    }, pool);
+    REQUIRE(count == n / 2);
+
+    auto copy = vec;
+    scattered::sort_by<k::x>(copy);
+    scattered::parallel_sort_by<k::x>(vec, std::less<>{}, pool);
+    REQUIRE(copy == vec);
+    REQUIRE(scattered::erase_if<k::b>(vec, [](bool b) { return b; }, pool)
+            == static_cast<std::size_t>(n / 2));
+    REQUIRE(vec.size() == static_cast<std::size_t>(n / 2));
+  }
+}
@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+#include "test_types.hpp"
+#include "scattered/vector.hpp"
+#include "scattered/for_each.hpp"
+
+/// Executor that counts the tasks it runs
+struct counting_executor {
+  std::size_t* no_tasks;
+  template <class F>
+  void parallel_for(const std::size_t n, const std::size_t, F&& f) const {
+    for (std::size_t i = 0; i != n; ++i) {
+      ++*no_tasks;
+      f(i, i + 1);
+    }
+  }
+};
+
+/// \test scattered::for_each_column tests
+TEST_CASE("Test scattered::for_each_column", "[scattered][for_each]") {
+  using k = TestType::k;
+  using scattered::get;
+
+  const int n = 1000;
+  scattered::vector<TestType> vec;
+  for (int i = 0; i != n; ++i) {
+    vec.push_back({static_cast<float>(i), 2. * i, i, i % 2 == 0});
+  }
+
+  SECTION("each column is processed by its own task") {
+    std::mutex m;
+    std::set<std::thread::id> ids;
+    scattered::for_each_column<k::x, k::y>(vec, [&](auto&& c) {
+      const auto max = *std::max_element(c.begin(), c.end());
+      for (auto&& i : c) { i /= max; }
+      std::lock_guard<std::mutex> lock(m);
+      ids.insert(std::this_thread::get_id());
+    }, scattered::thread_executor{2});
+    REQUIRE(ids.size() == 2);
+    for (int i = 0; i != n; ++i) {
+      REQUIRE(get<k::x>(vec, i) == Approx(i / (n - 1.)));
+      REQUIRE(get<k::y>(vec, i) == Approx(i / (n - 1.)));
+      REQUIRE(get<k::i>(vec, i) == i);
+    }
+  }
+  SECTION("all columns, const vectors and other executors") {
+    const auto& cvec = vec;
+    std::atomic<std::size_t> sizes{0};
+    scattered::for_each_column(cvec, [&](auto&& c) { sizes += c.size(); });
+    REQUIRE(sizes == 4 * static_cast<std::size_t>(n));
+    std::size_t no_tasks = 0;
+    scattered::for_each_column<k::i, k::b, k::x>(
+        vec, [](auto&& c) { std::reverse(c.begin(), c.end()); },
+        counting_executor{&no_tasks});
+    REQUIRE(no_tasks == 3);
+    REQUIRE(get<k::i>(vec, 0) == n - 1);
+    REQUIRE(get<k::y>(vec, 0) == Approx(0.));
+    scattered::for_each_column<k::i>(
+        vec, [](auto&& c) { std::sort(c.begin(), c.end()); },
+        scattered::sequential_executor{});
+    REQUIRE(get<k::i>(vec, 0) == 0);
+  }
+  SECTION("exceptions are rethrown after the join") {
+    std::atomic<int> done{0};
+    REQUIRE_THROWS_AS(scattered::for_each_column(vec, [&](auto&& c) {
+      ++done;
+      if (c.size() == static_cast<std::size_t>(n)) {
+        throw std::runtime_error("error");
+      }
+    }, scattered::thread_executor{4}), std::runtime_error);
+    REQUIRE(done == 4);
+  }
+}
+
+/// \test scattered::parallel_for tests
+template <class Vector> void test_parallel_for(Vector vec) {
+  using k = TestType::k;
+  using scattered::get;
+  using storage_type = typename Vector::storage_type;
+  constexpr std::size_t grain
+      = scattered::detail::cache_line_rows<storage_type>();
+
+  const int n = 5000;
+  for (int i = 0; i != n; ++i) {
+    vec.push_back({static_cast<float>(i), 2. * i, i, i % 2 == 0});
+  }
+  std::mutex m;
+  std::vector<std::pair<std::size_t, std::size_t>> chunks;
+  scattered::parallel_for(vec, [&](auto rows) {
+    for (auto&& r : rows) { get<k::y>(r) += get<k::i>(r); }
+    std::lock_guard<std::mutex> lock(m);
+    chunks.emplace_back(rows.begin() - vec.begin(), rows.end() - vec.begin());
+  }, scattered::thread_executor{3});
+  std::sort(chunks.begin(), chunks.end());
+  REQUIRE(chunks.size() == 3);
+  REQUIRE(chunks.front().first == 0);
+  REQUIRE(chunks.back().second == static_cast<std::size_t>(n));
+  for (std::size_t c = 1; c != chunks.size(); ++c) {
+    REQUIRE(chunks[c].first == chunks[c - 1].second);
+    REQUIRE(chunks[c].first % grain == 0);
+    // The boundaries fall on cache lines in every (aligned) column:
+    if (storage_type::alignment % 64 == 0) {
+      auto line = [](const void* p) {
+        return reinterpret_cast<std::uintptr_t>(p) % 64;
+      };
+      REQUIRE(line(&get<k::x>(vec, chunks[c].first)) == 0);
+      REQUIRE(line(&get<k::y>(vec, chunks[c].first)) == 0);
+      REQUIRE(line(&get<k::i>(vec, chunks[c].first)) == 0);
+    }
+  }
+  for (int i = 0; i != n; ++i) { REQUIRE(get<k::y>(vec, i) == Approx(3. * i)); }
+  const auto& cvec = vec;
+  std::atomic<int> count{0};
+  scattered::parallel_for(cvec, [&](auto rows) {
+    for (auto&& r : rows) { count += get<k::b>(r); }
+  });
+  REQUIRE(count == n / 2);
+}
+
+TEST_CASE("Test scattered::parallel_for", "[scattered][for_each]") {
+  using storage_type = scattered::vector<TestType>::storage_type;
+  // float: 16 rows, double: 8 rows, int: 16 rows, packed bool: 512 rows
+  static_assert(scattered::detail::cache_line_rows<storage_type>() == 512, "");
+  test_parallel_for(
+      scattered::vector<TestType, scattered::aligned_container_storage<64>>{});
+}
@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+#include "test_types.hpp"
+#include "scattered/vector.hpp"
+#include "scattered/frozen_vector.hpp"
+
+enum class Color : std::uint8_t { red, green, blue };
+
+struct Record {
+  std::int64_t id;        // sorted: delta
+  int small;              // small range: frame of reference
+  std::uint64_t key;      // few distinct, large values: dictionary
+  Color color;            // enumeration
+  bool flag;              // one bit
+  double value;           // not compressed
+  struct k {
+    struct id {};
+    struct small {};
+    struct key {};
+    struct color {};
+    struct flag {};
+    struct value {};
+  };
+};
+
+BOOST_FUSION_ADAPT_ASSOC_STRUCT(
+    Record, (std::int64_t, id, Record::k::id)(int, small, Record::k::small)(
+                std::uint64_t, key, Record::k::key)(Color, color,
+                                                    Record::k::color)(
+                bool, flag, Record::k::flag)(double, value, Record::k::value))
+
+/// \test scattered::frozen_vector tests
+TEST_CASE("Test scattered::frozen_vector<T>", "[scattered][frozen_vector]") {
+  using k = Record::k;
+  using scattered::get;
+  using scattered::encoding;
+
+  const std::size_t n = 10000;
+  scattered::vector<Record> vec;
+  for (std::size_t i = 0; i != n; ++i) {
+    vec.push_back({std::int64_t(1000000 + 3 * i + i % 2),
+                   int(i % 100) - 50,
+                   (std::uint64_t(1) << 40) * (i % 5),
+                   Color(i % 3),
+                   i % 7 == 0,
+                   0.5 * i});
+  }
+  const auto frozen = scattered::freeze(vec);
+
+  SECTION("each column uses the smallest encoding") {
+    REQUIRE(frozen.data<k::id>().encoding() == encoding::delta);
+    REQUIRE(frozen.data<k::small>().encoding()
+            == encoding::frame_of_reference);
+    REQUIRE(frozen.data<k::small>().width() == 7);
+    REQUIRE(frozen.data<k::key>().encoding() == encoding::dictionary);
+    REQUIRE(frozen.data<k::key>().width() == 3);
+    REQUIRE(frozen.data<k::color>().width() == 2);
+    REQUIRE(frozen.data<k::flag>().width() == 1);
+    REQUIRE(frozen.data<k::value>().encoding() == encoding::plain);
+    const std::size_t plain_bytes
+        = n * (sizeof(std::int64_t) + sizeof(int) + sizeof(std::uint64_t)
+               + sizeof(Color) + sizeof(bool) + sizeof(double));
+    REQUIRE(frozen.bytes() * 2 < plain_bytes);
+  }
+  SECTION("rows are decoded on access") {
+    REQUIRE(frozen.size() == n);
+    REQUIRE(frozen == vec);
+    for (std::size_t i = 0; i < n; i += 37) {
+      REQUIRE(get<k::id>(frozen, i) == get<k::id>(vec, i));
+      REQUIRE(get<k::small>(frozen, i) == get<k::small>(vec, i));
+      REQUIRE(get<k::key>(frozen[i]) == get<k::key>(vec[i]));
+      REQUIRE(get<k::color>(frozen[i]) == get<k::color>(vec[i]));
+      REQUIRE(get<k::flag>(frozen[i]) == get<k::flag>(vec[i]));
+      REQUIRE(get<k::value>(frozen[i]) == get<k::value>(vec[i]));
+    }
+    Record last = frozen.back();
+    REQUIRE(last.id == get<k::id>(vec, n - 1));
+    REQUIRE_THROWS_AS(frozen.at(n), std::out_of_range);
+    REQUIRE(std::count_if(frozen.begin(), frozen.end(), [](auto&& r) {
+              return get<k::flag>(r);
+            }) == (n + 6) / 7);
+  }
+  SECTION("blocks are decoded at once") {
+    std::int64_t sum = 0;
+    std::size_t rows = 0;
+    scattered::for_each_block<k::small>(frozen, [&](const int* v,
+                                                    std::size_t m) {
+      for (std::size_t i = 0; i != m; ++i) { sum += v[i]; }
+      rows += m;
+    });
+    REQUIRE(rows == n);
+    REQUIRE(sum == -50 * std::int64_t(n / 100));
+    std::vector<std::int64_t> ids;
+    scattered::for_each_block<k::id>(frozen, [&](auto v, std::size_t m) {
+      ids.insert(ids.end(), v, v + m);
+    });
+    REQUIRE(std::equal(ids.begin(), ids.end(), vec.data<k::id>().begin()));
+  }
+  SECTION("column iterators decode each row from the previous one") {
+    const auto& s = frozen.storage();
+    const auto& ids = vec.data<k::id>();
+    REQUIRE(std::equal(s.begin<k::id>(), s.end<k::id>(), ids.begin()));
+    REQUIRE(std::equal(std::make_reverse_iterator(s.end<k::id>()),
+                       std::make_reverse_iterator(s.begin<k::id>()),
+                       ids.rbegin()));
+    REQUIRE(std::equal(s.begin<k::key>(), s.end<k::key>(),
+                       vec.data<k::key>().begin()));
+    REQUIRE(s.end<k::id>() - s.begin<k::id>() == std::ptrdiff_t(n));
+    for (std::size_t i : {std::size_t(0), std::size_t(255), std::size_t(256),
+                          std::size_t(700), n - 1}) {
+      auto it = s.begin<k::id>() + i;
+      REQUIRE(*it == ids[i]);
+      if (i + 1 < n) { REQUIRE(*++it == ids[i + 1]); }
+      if (i > 0) {
+        it = s.begin<k::id>() + i;
+        REQUIRE(*--it == ids[i - 1]);
+      }
+    }
+    // A different row in any block is found:
+    auto changed = vec;
+    get<k::id>(changed, n - 1) += 1;
+    REQUIRE(!(frozen == changed));
+    changed = vec;
+    get<k::value>(changed, 300) = -1.;
+    REQUIRE(!(changed == frozen));
+  }
+  SECTION("extreme values") {
+    scattered::vector<Record> ext;
+    const auto min = std::numeric_limits<std::int64_t>::min();
+    const auto max = std::numeric_limits<std::int64_t>::max();
+    ext.push_back({max, -1, ~std::uint64_t(0), Color::blue, true, 1.});
+    ext.push_back({min, 1, 0, Color::red, false, 2.});
+    ext.push_back({0, std::numeric_limits<int>::min(), 1, Color::red, true,
+                   3.});
+    const auto f = scattered::freeze(ext);
+    REQUIRE(f == ext);
+    REQUIRE(f.data<k::id>().width() == 64);
+    const auto empty = scattered::freeze(scattered::vector<Record>{});
+    REQUIRE(empty.empty());
+    REQUIRE(empty.begin() == empty.end());
+  }
+}
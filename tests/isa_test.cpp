@@ -0,0 +1,78 @@
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+#include "scattered/detail/isa.hpp"
+#include "scattered/detail/mask.hpp"
+#include "scattered/detail/transform.hpp"
+
+/// \test instruction set selection
+TEST_CASE("Test scattered::selected_isa", "[scattered][isa]") {
+  using scattered::isa;
+  using scattered::detail::parse_isa;
+  REQUIRE(parse_isa(nullptr, isa::avx2) == isa::avx2);
+  REQUIRE(parse_isa("generic", isa::avx2) == isa::generic);
+  REQUIRE(parse_isa("sse4.2", isa::generic) == isa::sse4_2);
+  REQUIRE(parse_isa("avx2", isa::generic) == isa::avx2);
+  REQUIRE(parse_isa("avx512", isa::generic) == isa::avx512);
+  REQUIRE(parse_isa("neon", isa::sse4_2) == isa::sse4_2);
+  REQUIRE(scattered::selected_isa() <= scattered::detail::supported_isa());
+  REQUIRE(scattered::selected_isa() == scattered::selected_isa());
+}
+
+#if defined(SCATTERED_ISA_DISPATCH)
+/// \test every variant of the kernels computes the same results
+TEST_CASE("Test the kernel variants of each instruction set",
+          "[scattered][isa]") {
+  using scattered::isa;
+  using scattered::mask_type;
+  using namespace scattered::detail;
+  const std::size_t n = 1003;
+  std::vector<double> a(n);
+  std::vector<float> b(n);
+  for (std::size_t i = 0; i != n; ++i) {
+    a[i] = 0.25 * i;
+    b[i] = static_cast<float>(i % 17);
+  }
+  auto f = [](double x, float y) { return x * y + 1.; };
+  auto pred = [](float y) { return y > 8.f; };
+  auto op = std::plus<>{};
+
+  std::vector<float> expected(n);
+  transform_kernel::generic(n, expected.data(), f, a.data(), b.data());
+  const double expected_sum = reduce_kernel::generic(n, a.data(), 0., op);
+  mask_type expected_mask(n);
+  mask_kernel::generic(b.data(), n, pred, expected_mask.words());
+
+  auto check = [&](auto&& transform_fn, auto&& reduce_fn, auto&& mask_fn) {
+    std::vector<float> out(n);
+    transform_fn(n, out.data(), f, a.data(), b.data());
+    // Up to the contraction of x * y + 1. into a fused multiply-add:
+    for (std::size_t i = 0; i != n; ++i) {
+      REQUIRE(out[i] == Approx(expected[i]));
+    }
+    REQUIRE(reduce_fn(n, a.data(), 0., op) == Approx(expected_sum));
+    mask_type m(n);
+    mask_fn(b.data(), n, pred, m.words());
+    REQUIRE(m == expected_mask);
+  };
+  const isa supported = supported_isa();
+  if (supported >= isa::sse4_2) {
+    check([](auto&&... xs) { return transform_kernel::sse4_2(xs...); },
+          [](auto&&... xs) { return reduce_kernel::sse4_2(xs...); },
+          [](auto&&... xs) { return mask_kernel::sse4_2(xs...); });
+  }
+  if (supported >= isa::avx2) {
+    check([](auto&&... xs) { return transform_kernel::avx2(xs...); },
+          [](auto&&... xs) { return reduce_kernel::avx2(xs...); },
+          [](auto&&... xs) { return mask_kernel::avx2(xs...); });
+  }
+  if (supported >= isa::avx512) {
+    check([](auto&&... xs) { return transform_kernel::avx512(xs...); },
+          [](auto&&... xs) { return reduce_kernel::avx512(xs...); },
+          [](auto&&... xs) { return mask_kernel::avx512(xs...); });
+  }
+}
+#endif
@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+#include "test_types.hpp"
+#include "scattered/vector.hpp"
+#include "scattered/tiled_vector.hpp"
+#include "scattered/mapped_vector.hpp"
+#if defined(__linux__)
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/// Creates a temporary directory, and removes it when it goes out of scope
+struct temporary_directory {
+  std::string path;
+  temporary_directory() {
+    const char* tmp = std::getenv("TMPDIR");
+    std::string name = std::string(tmp ? tmp : "/tmp") + "/scatteredXXXXXX";
+    if (::mkdtemp(&name[0])) { path = name; }
+  }
+  ~temporary_directory() {
+    if (!path.empty()) { ::rmdir(path.c_str()); }
+  }
+};
+
+/// Evicts the pages of the file at path from the page cache, and returns
+/// whether it could
+static bool evict(const std::string& path) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd == -1) { return false; }
+  const bool ok = ::fdatasync(fd) == 0
+                  && ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+  ::close(fd);
+  return ok;
+}
+
+/// Number of the pages of the mapped range [p, p + bytes) that are in the
+/// page cache (p must be page aligned)
+static std::size_t resident_pages(const void* p, const std::size_t bytes) {
+  const std::size_t page = ::sysconf(_SC_PAGESIZE);
+  std::vector<unsigned char> pages((bytes + page - 1) / page);
+  if (::mincore(const_cast<void*>(p), bytes, pages.data()) != 0) { return 0; }
+  return std::count_if(pages.begin(), pages.end(),
+                       [](unsigned char c) { return c & 1; });
+}
+#endif
+
+/// Removes the file at path when it goes out of scope
+struct remove_on_exit {
+  std::string path;
+  ~remove_on_exit() { std::remove(path.c_str()); }
+};
+
+struct OtherType {
+  float x;
+  int y;
+  struct k {
+    struct x {};
+    struct y {};
+  };
+};
+
+BOOST_FUSION_ADAPT_ASSOC_STRUCT(OtherType, (float, x, OtherType::k::x)(
+                                               int, y, OtherType::k::y))
+
+/// \test scattered::mapped_vector tests
+TEST_CASE("Test scattered::mapped_vector<T>", "[scattered][mapped_vector]") {
+  using k = TestType::k;
+  using scattered::get;
+  const std::string path = "scattered_mapped_vector_test.dat";
+  const remove_on_exit remove_file{path};
+
+  scattered::vector<TestType> vec;
+  for (int i = 0; i != 10000; ++i) { vec.push_back(make_row(i)); }
+
+  SECTION("save and map") {
+    scattered::save(vec, path);
+    scattered::mapped_vector<TestType> m(path);
+    REQUIRE(m.size() == vec.size());
+    REQUIRE(m == vec);
+    for (std::size_t i = 0; i != vec.size(); ++i) {
+      REQUIRE(get<k::x>(m, i) == get<k::x>(vec, i));
+      REQUIRE(get<k::y>(m, i) == get<k::y>(vec, i));
+      REQUIRE(get<k::i>(m[i]) == get<k::i>(vec[i]));
+      REQUIRE(get<k::b>(m[i]) == get<k::b>(vec[i]));
+    }
+    // The columns are used in place, aligned to the page size:
+    auto x = reinterpret_cast<std::uintptr_t>(&get<k::x>(m, 0));
+    REQUIRE(x % 4096 == 0);
+    REQUIRE(std::accumulate(m.data<k::i>().begin(), m.data<k::i>().end(), 0L)
+            == 10000L * 9999L / 2);
+    REQUIRE(std::count(m.data<k::b>().begin(), m.data<k::b>().end(), true)
+            == 3334);
+    long sum = 0;
+    for (auto&& row : m) { sum += get<k::i>(row); }
+    REQUIRE(sum == 10000L * 9999L / 2);
+    TestType last = m.back();
+    REQUIRE(last == make_row(9999));
+    REQUIRE_THROWS_AS(m.at(10000), std::out_of_range);
+
+    scattered::mapped_vector<TestType> moved(std::move(m));
+    REQUIRE(moved == vec);
+  }
+  SECTION("any storage can be saved") {
+    scattered::tiled_vector<TestType, 64> tiled;
+    for (int i = 0; i != 1000; ++i) { tiled.push_back(make_row(i)); }
+    scattered::save(tiled, path);
+    scattered::mapped_vector<TestType> m(path);
+    vec.resize(1000);
+    REQUIRE(m == vec);
+  }
+  SECTION("load only some columns") {
+    scattered::save(vec, path);
+    auto m = scattered::load<TestType, k::x, k::b>(path);
+    REQUIRE(m.size() == vec.size());
+    for (std::size_t i = 0; i < vec.size(); i += 97) {
+      REQUIRE(get<k::x>(m, i) == get<k::x>(vec, i));
+      REQUIRE(get<k::b>(m, i) == get<k::b>(vec, i));
+    }
+    // The other columns are read on first access:
+    REQUIRE(get<k::y>(m, 9999) == get<k::y>(vec, 9999));
+    REQUIRE(m == vec);
+    m.prefetch<k::i>();
+    auto none = scattered::load<TestType>(path);
+    REQUIRE(none == vec);
+  }
+  SECTION("empty vector") {
+    scattered::save(scattered::vector<TestType>{}, path);
+    scattered::mapped_vector<TestType> m(path);
+    REQUIRE(m.empty());
+    REQUIRE(m.begin() == m.end());
+  }
+  SECTION("the schema is checked") {
+    scattered::save(vec, path);
+    REQUIRE_THROWS_AS(scattered::mapped_vector<OtherType>(path),
+                      std::runtime_error);
+    REQUIRE_THROWS_AS(scattered::mapped_vector<TestType>(path + ".missing"),
+                      std::runtime_error);
+  }
+}
+
+#if defined(__linux__)
+/// \test load<T, Ks...> only reads ahead the sections of the columns Ks
+///
+/// Observes the page cache with mincore after evicting the file, so it is
+/// skipped where the file cannot be evicted (e.g. on tmpfs).
+TEST_CASE("Test that scattered::load reads ahead only the selected columns",
+          "[scattered][mapped_vector]") {
+  using k = TestType::k;
+  const temporary_directory dir;
+  if (dir.path.empty() || ::sysconf(_SC_PAGESIZE) > 4096) {
+    WARN("skipped: no temporary directory or pages larger than 4 KB");
+    return;
+  }
+  const std::string path = dir.path + "/columns.dat";
+  const remove_on_exit remove_file{path};
+  {
+    // The columns are larger than the read-ahead window of the kernel (up to
+    // a few MB, see read_ahead_kb), so that it does not read them all:
+    scattered::vector<TestType> large;
+    large.resize(std::size_t(1) << 21);
+    scattered::save(large, path);
+  }
+  if (!evict(path)) {
+    WARN("skipped: the file cannot be evicted from the page cache");
+    return;
+  }
+  const auto m = scattered::load<TestType, k::x>(path);
+  const auto& s = m.storage();
+  const std::size_t n = m.size();
+  using scattered::detail::column_bytes;
+  const std::size_t x_pages = column_bytes<float>(n) / 4096;
+  const std::size_t y_pages = column_bytes<double>(n) / 4096;
+  const std::size_t i_pages = column_bytes<int>(n) / 4096;
+  auto resident = [&](auto key, std::size_t pages) {
+    return resident_pages(&*s.begin<decltype(key)>(), pages * 4096);
+  };
+  if (resident(k::i{}, i_pages) == i_pages) {
+    WARN("skipped: the file was not evicted from the page cache");
+    return;
+  }
+  // The read-ahead is asynchronous:
+  for (int t = 0; t != 100 && resident(k::x{}, x_pages) != x_pages; ++t) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  REQUIRE(resident(k::x{}, x_pages) == x_pages);
+  // The read-ahead of x may spill over the first pages of y:
+  REQUIRE(resident(k::y{}, y_pages) < y_pages);
+  REQUIRE(resident(k::i{}, i_pages) < i_pages / 2);
+}
+#endif
@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+#include "test_types.hpp"
+#include "scattered/mask.hpp"
+
+/// \test scattered::bit_vector tests
+TEST_CASE("Test scattered::bit_vector", "[scattered][bit_vector]") {
+  scattered::bit_vector<> bits;
+  std::vector<bool> ref;
+  for (int i = 0; i != 150; ++i) {
+    bits.push_back(i % 3 == 0);
+    ref.push_back(i % 3 == 0);
+  }
+
+  auto are_equal = [](auto const& b, auto const& r) {
+    REQUIRE(b.size() == r.size());
+    REQUIRE(std::equal(b.begin(), b.end(), r.begin()));
+    REQUIRE(b.count()
+            == static_cast<std::size_t>(std::count(r.begin(), r.end(), true)));
+  };
+
+  SECTION("packed in 64-bit words") {
+    are_equal(bits, ref);
+    REQUIRE(bits.no_words() == 3);
+    REQUIRE(bits.words()[0] == 0x9249249249249249ull);
+  }
+  SECTION("references") {
+    bits[1] = true;
+    ref[1] = true;
+    bits[0].flip();
+    ref[0].flip();
+    swap(bits[2], bits[3]);
+    swap(ref[2], ref[3]);
+    are_equal(bits, ref);
+    std::reverse(bits.begin(), bits.end());
+    std::reverse(ref.begin(), ref.end());
+    are_equal(bits, ref);
+  }
+  SECTION("resize/insert/erase/pop_back") {
+    bits.resize(200, true);
+    ref.resize(200, true);
+    are_equal(bits, ref);
+    bits.insert(bits.cbegin() + 10, 70, true);
+    ref.insert(ref.cbegin() + 10, 70, true);
+    are_equal(bits, ref);
+    bits.erase(bits.cbegin() + 5, bits.cbegin() + 100);
+    ref.erase(ref.cbegin() + 5, ref.cbegin() + 100);
+    are_equal(bits, ref);
+    while (bits.size() > 63) {
+      bits.pop_back();
+      ref.pop_back();
+    }
+    are_equal(bits, ref);
+    bits.resize(10);
+    ref.resize(10);
+    are_equal(bits, ref);
+  }
+  SECTION("any/all/none") {
+    REQUIRE(bits.any());
+    REQUIRE(!bits.all());
+    REQUIRE((~bits | bits).all());
+    REQUIRE((~bits & bits).none());
+    REQUIRE((~bits).count() == 100);
+    REQUIRE((bits ^ bits).none());
+    scattered::bit_vector<> ones(130, true);
+    REQUIRE(ones.all());
+    REQUIRE(ones.count() == 130);
+    REQUIRE(scattered::bit_vector<>().all());
+  }
+  SECTION("for_each_set") {
+    std::vector<std::size_t> set;
+    bits.for_each_set([&](std::size_t i) { set.push_back(i); });
+    REQUIRE(set.size() == 50);
+    for (std::size_t i = 0; i != set.size(); ++i) { REQUIRE(set[i] == 3 * i); }
+  }
+}
+
+/// \test bool column queries and bitmasks of scattered::vector
+TEST_CASE("Test scattered::vector bool columns and masks",
+          "[scattered][vector][mask]") {
+  using k = TestType::k;
+  using scattered::get;
+
+  auto test = [](auto vec) {
+    for (int i = 0; i != 100; ++i) {
+      vec.push_back({static_cast<float>(i), static_cast<double>(i), i,
+                     i % 4 == 0});
+    }
+    REQUIRE(scattered::count<k::b>(vec) == 25);
+    REQUIRE(scattered::any<k::b>(vec));
+    REQUIRE(!scattered::all<k::b>(vec));
+    REQUIRE(!scattered::none<k::b>(vec));
+
+    auto small = scattered::mask<k::x>(vec, [](float x) { return x < 50.f; });
+    auto odd = scattered::mask<k::i>(vec, [](int i) { return i % 2 == 1; });
+    REQUIRE(small.size() == 100);
+    REQUIRE(small.count() == 50);
+    REQUIRE((small & odd).count() == 25);
+    REQUIRE(scattered::mask<k::b>(vec).count() == 25);
+
+    scattered::assign<k::b>(vec, small);
+    REQUIRE(scattered::count<k::b>(vec) == 50);
+    for (std::size_t i = 0; i != vec.size(); ++i) {
+      REQUIRE(get<k::b>(vec, i) == (i < 50));
+    }
+    scattered::assign<k::b>(vec, small | ~small);
+    REQUIRE(scattered::all<k::b>(vec));
+  };
+
+  SECTION("container_storage packs bool columns") {
+    using vector_t = scattered::vector<TestType>;
+    static_assert(std::is_same<vector_t::container_type<bool>,
+                               scattered::bit_vector<>>::value,
+                  "bool columns should be bit_vectors");
+    test(vector_t{});
+
+    vector_t vec(130);
+    get<k::b>(vec[129]) = true;
+    REQUIRE(vec.data<k::b>().no_words() == 3);
+    REQUIRE(scattered::count<k::b>(vec) == 1);
+    REQUIRE(static_cast<TestType>(vec[129]).b);
+  }
+  SECTION("other storages") {
+    test(scattered::vector<TestType, scattered::arena_storage<>>{});
+  }
+}
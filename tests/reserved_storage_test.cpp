@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+#include "test_types.hpp"
+#include "scattered/vector.hpp"
+#include "scattered/reserved_storage.hpp"
+
+/// Number of copies and moves performed by counted
+static std::size_t no_copies = 0;
+
+struct counted {
+  std::string s;
+  counted() = default;
+  counted(std::string s_) : s(std::move(s_)) {}
+  counted(const counted& o) : s(o.s) { ++no_copies; }
+  counted(counted&& o) : s(std::move(o.s)) { ++no_copies; }
+  counted& operator=(const counted&) = default;
+  counted& operator=(counted&&) = default;
+};
+
+/// Type whose copies throw after a number of copies
+static std::size_t no_copies_before_throw = 0;
+
+struct throws_on_copy {
+  int i = 0;
+  throws_on_copy() = default;
+  throws_on_copy(const throws_on_copy& o) : i(o.i) {
+    if (no_copies_before_throw-- == 0) { throw std::runtime_error("copy"); }
+  }
+  throws_on_copy& operator=(const throws_on_copy&) = default;
+};
+
+/// Virtual memory size of the process in kB (0 if unknown)
+static std::size_t virtual_memory_kb() {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.compare(0, 7, "VmSize:") == 0) {
+      return std::stoul(line.substr(7));
+    }
+  }
+  return 0;
+}
+
+/// \test scattered::reserved_storage tests
+TEST_CASE("Test scattered::vector<T, reserved_storage<MaxRows>>",
+          "[scattered][reserved_storage]") {
+  using k = TestType::k;
+  using scattered::get;
+  using vector_t = scattered::vector<TestType, scattered::reserved_storage<>>;
+
+  vector_t vec;
+  std::vector<TestType> ref;
+  for (int i = 0; i != 10; ++i) {
+    vec.push_back(make_row(i));
+    ref.push_back(make_row(i));
+  }
+
+  SECTION("growing does not move the columns") {
+    const auto x = &get<k::x>(vec, 0);
+    const auto y = &get<k::y>(vec, 0);
+    for (int i = 10; i != 100000; ++i) {
+      vec.push_back(make_row(i));
+      ref.push_back(make_row(i));
+    }
+    vec.resize(300000);
+    ref.resize(300000);
+    REQUIRE(&get<k::x>(vec, 0) == x);
+    REQUIRE(&get<k::y>(vec, 0) == y);
+    check_equal(vec, ref);
+
+    vec.resize(5);
+    ref.resize(5);
+    vec.shrink_to_fit();
+    REQUIRE(vec.capacity() < 300000);
+    REQUIRE(&get<k::x>(vec, 0) == x);
+    check_equal(vec, ref);
+  }
+  SECTION("copy, move and swap") {
+    vector_t copy(vec);
+    REQUIRE(copy == vec);
+    REQUIRE(&get<k::x>(copy, 0) != &get<k::x>(vec, 0));
+    vector_t moved(std::move(copy));
+    REQUIRE(moved == vec);
+    REQUIRE(copy.empty());
+    vector_t other;
+    other.push_back(make_row(-1));
+    swap(other, moved);
+    check_equal(other, ref);
+    REQUIRE(moved.size() == 1);
+    copy = other;
+    check_equal(copy, ref);
+  }
+  SECTION("insert and erase") {
+    vec.erase(vec.cbegin() + 2, vec.cbegin() + 5);
+    ref.erase(ref.cbegin() + 2, ref.cbegin() + 5);
+    check_equal(vec, ref);
+    vec.insert(vec.cbegin() + 1, make_row(42));
+    ref.insert(ref.cbegin() + 1, make_row(42));
+    check_equal(vec, ref);
+    std::reverse(vec.begin(), vec.end());
+    std::reverse(ref.begin(), ref.end());
+    check_equal(vec, ref);
+    vec.clear();
+    vec.shrink_to_fit();
+    REQUIRE(vec.empty());
+    REQUIRE(vec.capacity() == 0);
+    vec.push_back(make_row(7));
+    REQUIRE(get<k::i>(vec, 0) == 7);
+  }
+  SECTION("growing past MaxRows throws std::bad_alloc") {
+    scattered::vector<TestType, scattered::reserved_storage<16>> small;
+    small.resize(16);
+    REQUIRE(small.max_size() == 16);
+    REQUIRE_THROWS_AS(small.push_back(make_row(0)), std::bad_alloc);
+    REQUIRE(small.size() == 16);
+  }
+}
+
+/// \test scattered::reserved_vector never copies or moves its elements
+TEST_CASE("Test scattered::reserved_vector<T, MaxSize>",
+          "[scattered][reserved_storage]") {
+  scattered::reserved_vector<counted> vec;
+  for (int i = 0; i != 10000; ++i) { vec.emplace_back(std::to_string(i)); }
+  REQUIRE(no_copies == 0);
+  vec.resize(20000);
+  REQUIRE(no_copies == 0);
+  for (int i = 0; i != 10000; ++i) { REQUIRE(vec[i].s == std::to_string(i)); }
+  vec.erase(vec.cbegin(), vec.cbegin() + 9999);
+  REQUIRE(vec.front().s == "9999");
+  REQUIRE(vec.size() == 10001);
+}
+
+TEST_CASE("Test that reserved_vector releases its reservation on throw",
+          "[scattered][reserved_storage]") {
+  // Each reservation is 4 GB of address space:
+  using vector_t = scattered::reserved_vector<throws_on_copy>;
+  const vector_t vec(1000);
+  const std::size_t before = virtual_memory_kb();
+  for (int i = 0; i != 8; ++i) {
+    no_copies_before_throw = 500;
+    REQUIRE_THROWS_AS(vector_t{vec}, std::runtime_error);
+  }
+  // The reservations are released (if the size is known):
+  REQUIRE(virtual_memory_kb() < before + (std::size_t(1) << 20));
+}
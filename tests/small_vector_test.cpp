@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+#include "test_types.hpp"
+#include "scattered/small_vector.hpp"
+
+/// Number of allocations performed by counting_allocator
+static std::size_t no_allocations = 0;
+
+template <class T> struct counting_allocator {
+  using value_type = T;
+  counting_allocator() = default;
+  template <class U> counting_allocator(const counting_allocator<U>&) {}
+  T* allocate(const std::size_t n) {
+    ++no_allocations;
+    return std::allocator<T>{}.allocate(n);
+  }
+  void deallocate(T* p, const std::size_t n) {
+    std::allocator<T>{}.deallocate(p, n);
+  }
+  friend bool operator==(const counting_allocator&, const counting_allocator&) {
+    return true;
+  }
+  friend bool operator!=(const counting_allocator&, const counting_allocator&) {
+    return false;
+  }
+};
+
+/// \test scattered::small_vector tests
+TEST_CASE("Test scattered::small_vector<T, N>",
+          "[scattered][small_vector]") {
+  using k = TestType::k;
+  using scattered::get;
+  using vector_t
+      = scattered::small_vector<TestType, 8, counting_allocator<char>>;
+
+  no_allocations = 0;
+  vector_t vec;
+  std::vector<TestType> ref;
+  for (int i = 0; i != 8; ++i) {
+    vec.push_back(make_row(i));
+    ref.push_back(make_row(i));
+  }
+
+  SECTION("up to N rows are stored inline") {
+    REQUIRE(vec.capacity() == 8);
+    REQUIRE(vec.storage().is_inline());
+    check_equal(vec, ref);
+    vector_t copy(vec);
+    vector_t moved(std::move(copy));
+    REQUIRE(moved == vec);
+    REQUIRE(copy.empty());
+    vec.erase(vec.cbegin() + 1, vec.cbegin() + 3);
+    vec.insert(vec.cbegin(), make_row(42));
+    REQUIRE(no_allocations == 0);
+    // The columns live inside the object:
+    auto first = reinterpret_cast<const char*>(&vec);
+    auto x = reinterpret_cast<const char*>(&get<k::x>(vec, 0));
+    auto b = reinterpret_cast<const char*>(&get<k::b>(vec, 7));
+    REQUIRE(x >= first);
+    REQUIRE(b < first + sizeof(vector_t));
+  }
+  SECTION("growing past N moves all the columns to the heap at once") {
+    for (int i = 8; i != 40; ++i) {
+      vec.push_back(make_row(i));
+      ref.push_back(make_row(i));
+    }
+    REQUIRE(!vec.storage().is_inline());
+    REQUIRE(no_allocations <= 3);
+    check_equal(vec, ref);
+
+    vector_t moved(std::move(vec));
+    REQUIRE(vec.empty());
+    REQUIRE(vec.capacity() == 8);
+    check_equal(moved, ref);
+
+    moved.resize(5);
+    ref.resize(5);
+    moved.shrink_to_fit();
+    REQUIRE(moved.storage().is_inline());
+    REQUIRE(moved.capacity() == 8);
+    check_equal(moved, ref);
+  }
+  SECTION("swap") {
+    vector_t big;
+    std::vector<TestType> big_ref;
+    for (int i = 0; i != 20; ++i) {
+      big.push_back(make_row(100 + i));
+      big_ref.push_back(make_row(100 + i));
+    }
+    vector_t small;
+    small.push_back(make_row(-1));
+    std::vector<TestType> small_ref = {make_row(-1)};
+
+    swap(vec, big);
+    check_equal(vec, big_ref);
+    check_equal(big, ref);
+    swap(small, big);
+    check_equal(small, ref);
+    check_equal(big, small_ref);
+    swap(vec, vec);
+    check_equal(vec, big_ref);
+    vector_t other(vec);
+    swap(other, vec);
+    check_equal(vec, big_ref);
+    check_equal(other, big_ref);
+  }
+  SECTION("algorithms") {
+    std::reverse(vec.begin(), vec.end());
+    std::reverse(ref.begin(), ref.end());
+    check_equal(vec, ref);
+    vec.clear();
+    REQUIRE(vec.empty());
+    REQUIRE(vec.capacity() == 8);
+  }
+}
+
+TEST_CASE("Test that moving a small_vector propagates the exceptions of moving "
+          "its inline rows", "[scattered][small_vector]") {
+  using k = ThrowingMoveType::k;
+  using scattered::get;
+  using vector_t = scattered::small_vector<ThrowingMoveType, 4>;
+  static_assert(
+      !std::is_nothrow_move_constructible<vector_t::storage_type>::value, "");
+  static_assert(std::is_nothrow_move_constructible
+                <scattered::small_vector<TestType, 4>::storage_type>::value,
+                "");
+
+  vector_t vec;
+  for (int i = 0; i != 3; ++i) { vec.push_back({i, i}); }
+  throws_on_move::enabled() = true;
+  REQUIRE_THROWS_AS(vector_t(std::move(vec)), std::runtime_error);
+  vector_t other;
+  REQUIRE_THROWS_AS(other = std::move(vec), std::runtime_error);
+  throws_on_move::enabled() = false;
+  REQUIRE(vec.size() == 3);
+  REQUIRE(other.empty());
+  for (int i = 0; i != 3; ++i) { REQUIRE(get<k::i>(vec, i) == i); }
+
+  // Rows on the heap are not moved one by one:
+  for (int i = 3; i != 10; ++i) { vec.push_back({i, i}); }
+  throws_on_move::enabled() = true;
+  vector_t moved(std::move(vec));
+  throws_on_move::enabled() = false;
+  REQUIRE(moved.size() == 10);
+  REQUIRE(get<k::m>(moved, 9).value == 9);
+}
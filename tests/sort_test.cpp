@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <vector>
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+#include "test_types.hpp"
+#include "scattered/vector.hpp"
+#include "scattered/sort.hpp"
+
+/// \test scattered::argsort and scattered::sort_by tests
+TEST_CASE("Test scattered::sort_by<K>", "[scattered][sort]") {
+  using k = TestType::k;
+  using scattered::get;
+
+  const int n = 1000;
+  std::vector<TestType> ref;
+  scattered::vector<TestType> vec;
+  for (int i = 0; i != n; ++i) {
+    const TestType t{static_cast<float>((i * 7919) % 101),
+                     static_cast<double>(i), i, i % 3 == 0};
+    ref.push_back(t);
+    vec.push_back(t);
+  }
+  auto check = [&](auto&& v) {
+    REQUIRE(v.size() == ref.size());
+    for (std::size_t i = 0; i != ref.size(); ++i) {
+      REQUIRE(get<k::x>(v, i) == Approx(ref[i].x));
+      REQUIRE(get<k::y>(v, i) == Approx(ref[i].y));
+      REQUIRE(get<k::i>(v, i) == ref[i].i);
+      REQUIRE(get<k::b>(v, i) == ref[i].b);
+    }
+  };
+
+  SECTION("argsort only computes the permutation") {
+    const auto p = scattered::argsort<k::x>(vec);
+    REQUIRE(p.size() == static_cast<std::size_t>(n));
+    for (std::size_t i = 1; i != p.size(); ++i) {
+      REQUIRE(get<k::x>(vec, p[i - 1]) <= get<k::x>(vec, p[i]));
+      if (get<k::x>(vec, p[i - 1]) == get<k::x>(vec, p[i])) {
+        REQUIRE(p[i - 1] < p[i]);  // stable
+      }
+    }
+    REQUIRE(get<k::i>(vec, 10) == 10);
+  }
+  SECTION("sort_by is a stable sort of the rows") {
+    std::stable_sort(ref.begin(), ref.end(),
+                     [](auto a, auto b) { return a.x < b.x; });
+    scattered::sort_by<k::x>(vec);
+    check(vec);
+    std::stable_sort(ref.begin(), ref.end(),
+                     [](auto a, auto b) { return a.b > b.b; });
+    scattered::sort_by<k::b>(vec, std::greater<>{});
+    check(vec);
+  }
+  SECTION("permute and permute_in_place agree") {
+    const auto p = scattered::argsort<k::x>(vec, std::greater<>{});
+    auto copy = vec;
+    scattered::permute(vec, p);
+    scattered::permute_in_place(copy, p);
+    REQUIRE(copy == vec);
+    std::vector<TestType> tmp;
+    for (auto i : p) { tmp.push_back(ref[i]); }
+    ref = tmp;
+    check(copy);
+    // The identity and an empty vector:
+    scattered::permutation id(vec.size());
+    std::iota(id.begin(), id.end(), 0);
+    scattered::permute_in_place(vec, id);
+    check(vec);
+    scattered::vector<TestType> empty;
+    scattered::sort_by<k::i>(empty);
+    REQUIRE(empty.empty());
+  }
+  SECTION("parallel sort") {
+    for (std::size_t no_threads : {1, 2, 3, 7, 16}) {
+      REQUIRE(scattered::parallel_argsort<k::x>(vec, std::less<>{}, no_threads)
+              == scattered::argsort<k::x>(vec));
+      REQUIRE(scattered::parallel_argsort<k::b>(vec, std::greater<>{},
+                                                no_threads)
+              == scattered::argsort<k::b>(vec, std::greater<>{}));
+    }
+    auto copy = vec;
+    scattered::sort_by<k::x>(copy);
+    scattered::parallel_sort_by<k::x>(vec, std::less<>{}, 5);
+    REQUIRE(copy == vec);
+    scattered::vector<TestType> few;
+    for (int i = 0; i != 3; ++i) { few.push_back(ref[i]); }
+    scattered::parallel_sort_by<k::i>(few, std::greater<>{}, 16);
+    REQUIRE(get<k::i>(few, 0) == 2);
+    REQUIRE(get<k::i>(few, 2) == 0);
+    scattered::vector<TestType> empty;
+    REQUIRE(scattered::parallel_argsort<k::x>(empty, std::less<>{}, 4).empty());
+    scattered::parallel_sort_by<k::x>(empty, std::less<>{}, 4);
+    scattered::work_stealing_executor pool(4);
+    REQUIRE(scattered::parallel_argsort<k::x>(empty, std::less<>{}, pool)
+                .empty());
+    scattered::parallel_sort_by<k::x>(empty, std::less<>{}, pool);
+    REQUIRE(empty.empty());
+  }
+  SECTION("radix sort") {
+    scattered::vector<TestType> signs;
+    for (int i = 0; i != n; ++i) {
+      const int j = (i * 7919) % 1009 - 504;
+      signs.push_back({0.25f * j, -1e300 * j, j * 4000000, j % 3 == 0});
+    }
+    signs.push_back({std::numeric_limits<float>::infinity(),
+                     -std::numeric_limits<double>::infinity(),
+                     std::numeric_limits<int>::min(), true});
+    signs.push_back({-std::numeric_limits<float>::infinity(),
+                     std::numeric_limits<double>::infinity(),
+                     std::numeric_limits<int>::max(), false});
+    REQUIRE(scattered::radix_argsort<k::x>(signs)
+            == scattered::argsort<k::x>(signs));
+    REQUIRE(scattered::radix_argsort<k::y>(signs)
+            == scattered::argsort<k::y>(signs));
+    REQUIRE(scattered::radix_argsort<k::i>(signs)
+            == scattered::argsort<k::i>(signs));
+    REQUIRE(scattered::radix_argsort<k::b>(signs)
+            == scattered::argsort<k::b>(signs));
+    // Composite keys: b first, then x
+    scattered::permutation p(signs.size());
+    std::iota(p.begin(), p.end(), 0);
+    std::stable_sort(p.begin(), p.end(), [&](auto l, auto r) {
+      return std::make_pair(get<k::b>(signs, l), get<k::x>(signs, l))
+             < std::make_pair(get<k::b>(signs, r), get<k::x>(signs, r));
+    });
+    REQUIRE((scattered::radix_argsort<k::b, k::x>(signs)) == p);
+
+    std::stable_sort(ref.begin(), ref.end(),
+                     [](auto a, auto b) { return a.i < b.i; });
+    std::stable_sort(ref.begin(), ref.end(),
+                     [](auto a, auto b) { return a.x < b.x; });
+    scattered::radix_sort_by<k::x, k::i>(vec);
+    check(vec);
+  }
+  SECTION("arena storage") {
+    scattered::vector<TestType, scattered::arena_storage<>> arena;
+    for (auto&& t : ref) { arena.push_back(t); }
+    std::stable_sort(ref.begin(), ref.end(),
+                     [](auto a, auto b) { return a.y > b.y; });
+    scattered::sort_by<k::y>(arena, std::greater<>{});
+    check(arena);
+  }
+}
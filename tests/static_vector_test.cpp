@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+#include "test_types.hpp"
+#include "scattered/static_vector.hpp"
+
+/// \test scattered::static_vector tests
+TEST_CASE("Test scattered::static_vector<T, Capacity>",
+          "[scattered][static_vector]") {
+  using k = TestType::k;
+  using scattered::get;
+  using vector_t = scattered::static_vector<TestType, 32>;
+
+  static_assert(vector_t::storage_type::capacity() == 32,
+                "the capacity should be a compile-time constant");
+  static_assert(sizeof(vector_t) >= 32 * (sizeof(float) + sizeof(double)
+                                          + sizeof(int) + sizeof(bool)),
+                "the columns should be stored inside the vector");
+
+  vector_t vec;
+  std::vector<TestType> ref;
+  for (int i = 0; i != 20; ++i) {
+    vec.push_back(make_row(i));
+    ref.push_back(make_row(i));
+  }
+
+  SECTION("push_back/iterators") {
+    check_equal(vec, ref);
+    REQUIRE(vec.capacity() == 32);
+    REQUIRE(vec.max_size() == 32);
+    REQUIRE((vec.end() - vec.begin()) == 20);
+    REQUIRE(std::count(get<k::b>(vec.cbegin()), get<k::b>(vec.cend()), true)
+            == 7);
+  }
+  SECTION("the columns are at fixed offsets inside the vector") {
+    vector_t other;
+    other.push_back(make_row(0));
+    auto offset = [](auto const& v, auto p) {
+      return reinterpret_cast<const char*>(p)
+             - reinterpret_cast<const char*>(&v);
+    };
+    REQUIRE(offset(vec, &get<k::y>(vec, 0))
+            == offset(other, &get<k::y>(other, 0)));
+    REQUIRE(offset(vec, &get<k::b>(vec, 31)) < std::ptrdiff_t(sizeof(vec)));
+  }
+  SECTION("growing past the capacity throws") {
+    vec.resize(32);
+    REQUIRE_THROWS_AS(vec.push_back(make_row(32)), std::bad_alloc);
+    REQUIRE(vec.size() == 32);
+    REQUIRE_THROWS_AS(vec.reserve(33), std::bad_alloc);
+    REQUIRE_THROWS_AS(vec.resize(33), std::bad_alloc);
+  }
+  SECTION("resize/insert/erase/clear") {
+    vec.resize(25);
+    ref.resize(25);
+    check_equal(vec, ref);
+    vec.insert(vec.cbegin() + 3, make_row(-1));
+    ref.insert(ref.cbegin() + 3, make_row(-1));
+    check_equal(vec, ref);
+    vec.erase(vec.cbegin() + 5, vec.cbegin() + 15);
+    ref.erase(ref.cbegin() + 5, ref.cbegin() + 15);
+    check_equal(vec, ref);
+    vec.pop_back();
+    ref.pop_back();
+    check_equal(vec, ref);
+    vec.clear();
+    REQUIRE(vec.empty());
+  }
+  SECTION("copy/move/swap") {
+    vector_t copy(vec);
+    REQUIRE(copy == vec);
+    vector_t moved(std::move(copy));
+    REQUIRE(moved == vec);
+    vector_t other;
+    other.push_back(make_row(7));
+    swap(other, moved);
+    REQUIRE(other == vec);
+    REQUIRE(moved.size() == 1);
+    other = moved;
+    REQUIRE(other == moved);
+  }
+  SECTION("algorithms") {
+    std::reverse(vec.begin(), vec.end());
+    std::reverse(ref.begin(), ref.end());
+    check_equal(vec, ref);
+  }
+}
+
+TEST_CASE("Test that swapping static_vectors propagates the exceptions of "
+          "moving their rows", "[scattered][static_vector]") {
+  using k = ThrowingMoveType::k;
+  using scattered::get;
+  using vector_t = scattered::static_vector<ThrowingMoveType, 8>;
+  vector_t a, b;
+  static_assert(!noexcept(swap(a, b)), "");
+  using nothrow_vector_t = scattered::static_vector<TestType, 8>;
+  static_assert(noexcept(swap(std::declval<nothrow_vector_t&>(),
+                              std::declval<nothrow_vector_t&>())),
+                "");
+  static_assert(noexcept(swap(std::declval<scattered::vector<TestType>&>(),
+                              std::declval<scattered::vector<TestType>&>())),
+                "");
+
+  for (int i = 0; i != 3; ++i) { a.push_back({i, i}); }
+  b.push_back({7, 7});
+  throws_on_move::enabled() = true;
+  REQUIRE_THROWS_AS(swap(a, b), std::runtime_error);
+  throws_on_move::enabled() = false;
+  // The first move threw, so no row was moved:
+  REQUIRE(a.size() == 3);
+  REQUIRE(b.size() == 1);
+  swap(a, b);
+  REQUIRE(a.size() == 1);
+  REQUIRE(get<k::m>(a, 0).value == 7);
+  REQUIRE(b.size() == 3);
+  for (int i = 0; i != 3; ++i) { REQUIRE(get<k::i>(b, i) == i); }
+}
@@ -6,7 +6,11 @@
 #if !defined(SCATTERED_TESTS_TEST_TYPES_HPP)
 #define SCATTERED_TESTS_TEST_TYPES_HPP
 
+#include <cstddef>
+#include <stdexcept>
 #include <boost/fusion/adapted/struct/adapt_assoc_struct.hpp>
+#include <catch.hpp>
+#include "scattered/detail/get.hpp"
 
 struct TestType {
   float x;
@@ -31,4 +35,55 @@ BOOST_FUSION_ADAPT_ASSOC_STRUCT(
     TestType, (float, x, TestType::k::x)(double, y, TestType::k::y)(
                   int, i, TestType::k::i)(bool, b, TestType::k::b))
 
+/// Row i of the vectors of the tests
+inline TestType make_row(const int i) {
+  return TestType{static_cast<float>(i), static_cast<double>(2 * i), i,
+                  i % 3 == 0};
+}
+
+/// Checks that the scattered vector vc stores the rows of ref
+template <class Vector, class Reference>
+void check_equal(const Vector& vc, const Reference& ref) {
+  using k = TestType::k;
+  using scattered::get;
+  REQUIRE(vc.size() == ref.size());
+  for (std::size_t i = 0; i != ref.size(); ++i) {
+    REQUIRE(get<k::x>(vc, i) == Approx(ref[i].x));
+    REQUIRE(get<k::y>(vc, i) == Approx(ref[i].y));
+    REQUIRE(get<k::i>(vc[i]) == ref[i].i);
+    REQUIRE(get<k::b>(vc[i]) == ref[i].b);
+    REQUIRE(static_cast<TestType>(vc[i]) == ref[i]);
+  }
+}
+
+/// Value whose move constructor throws while throws_on_move::enabled() is set
+struct throws_on_move {
+  int value = 0;
+  static bool& enabled() {
+    static bool e = false;
+    return e;
+  }
+  throws_on_move() = default;
+  throws_on_move(int v) : value(v) {}
+  throws_on_move(const throws_on_move&) = default;
+  throws_on_move(throws_on_move&& o) : value(o.value) {
+    if (enabled()) { throw std::runtime_error("move"); }
+  }
+  throws_on_move& operator=(const throws_on_move&) = default;
+  throws_on_move& operator=(throws_on_move&&) = default;
+};
+
+struct ThrowingMoveType {
+  int i;
+  throws_on_move m;
+  struct k {
+    struct i {};
+    struct m {};
+  };
+};
+
+BOOST_FUSION_ADAPT_ASSOC_STRUCT(
+    ThrowingMoveType, (int, i, ThrowingMoveType::k::i)(
+                          throws_on_move, m, ThrowingMoveType::k::m))
+
 #endif  // SCATTERED_TESTS_TEST_TYPES_HPP
@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+#include "test_types.hpp"
+#include "scattered/tiled_vector.hpp"
+
+/// \test scattered::tiled_vector tests
+TEST_CASE("Test scattered::tiled_vector<T, TileSize>",
+          "[scattered][tiled_vector]") {
+  using k = TestType::k;
+  using scattered::get;
+  using vector_t = scattered::tiled_vector<TestType, 8>;
+  using layout = vector_t::storage_type::layout_type;
+
+  vector_t vec;
+  std::vector<TestType> ref;
+  for (int i = 0; i != 29; ++i) {
+    vec.push_back(make_row(i));
+    ref.push_back(make_row(i));
+  }
+
+  SECTION("push_back/iterators") {
+    check_equal(vec, ref);
+    REQUIRE(vec.capacity() % 8 == 0);
+    REQUIRE((vec.end() - vec.begin()) == 29);
+    REQUIRE(std::equal(vec.data<k::i>().begin(), vec.data<k::i>().end(),
+                       vec.data<k::i>().begin()));
+    auto x = get<k::x>(vec.begin());
+    REQUIRE(std::distance(x, get<k::x>(vec.end())) == 29);
+    REQUIRE(std::count(get<k::b>(vec.cbegin()), get<k::b>(vec.cend()), true)
+            == 10);
+  }
+  SECTION("each tile stores the elements of every column contiguously") {
+    auto x0 = reinterpret_cast<const char*>(&get<k::x>(vec, 0));
+    auto x1 = reinterpret_cast<const char*>(&get<k::x>(vec, 1));
+    auto x8 = reinterpret_cast<const char*>(&get<k::x>(vec, 8));
+    auto y0 = reinterpret_cast<const char*>(&get<k::y>(vec, 0));
+    auto b7 = reinterpret_cast<const char*>(&get<k::b>(vec, 7));
+    REQUIRE(x1 - x0 == static_cast<std::ptrdiff_t>(sizeof(float)));
+    REQUIRE(x8 - x0 == static_cast<std::ptrdiff_t>(layout::tile_bytes));
+    REQUIRE(y0 - x0 == static_cast<std::ptrdiff_t>(8 * sizeof(float)));
+    REQUIRE(b7 < x8);
+  }
+  SECTION("tiles") {
+    auto ts = scattered::tiles(vec);
+    REQUIRE(ts.size() == 4);
+    REQUIRE(ts[0].full());
+    REQUIRE(ts[3].size() == 5);
+    REQUIRE(!ts[3].full());
+    for (auto t : ts) {
+      auto x = get<k::x>(t);
+      auto y = get<k::y>(t);
+      for (std::size_t i = 0; i != t.size(); ++i) { x[i] += y[i]; }
+    }
+    for (auto& r : ref) { r.x += r.y; }
+    check_equal(vec, ref);
+
+    const auto& cvec = vec;
+    int sum = 0;
+    for (auto t : scattered::tiles(cvec)) {
+      const int* i = get<k::i>(t);
+      for (std::size_t j = 0; j != t.size(); ++j) { sum += i[j]; }
+    }
+    REQUIRE(sum == 29 * 28 / 2);
+  }
+  SECTION("reserve/resize/clear") {
+    vec.reserve(100);
+    REQUIRE(vec.capacity() == 104);
+    check_equal(vec, ref);
+    vec.resize(50);
+    ref.resize(50);
+    check_equal(vec, ref);
+    vec.resize(3);
+    ref.resize(3);
+    vec.shrink_to_fit();
+    REQUIRE(vec.capacity() == 8);
+    check_equal(vec, ref);
+    vec.clear();
+    REQUIRE(vec.empty());
+  }
+  SECTION("insert/erase") {
+    TestType t = {-1.0, -2.0, -3, true};
+    vec.insert(vec.cbegin() + 10, t);
+    ref.insert(ref.cbegin() + 10, t);
+    check_equal(vec, ref);
+    vec.erase(vec.cbegin() + 2, vec.cbegin() + 12);
+    ref.erase(ref.cbegin() + 2, ref.cbegin() + 12);
+    check_equal(vec, ref);
+  }
+  SECTION("copy/move/swap") {
+    vector_t copy(vec);
+    REQUIRE(copy == vec);
+    vector_t moved(std::move(copy));
+    REQUIRE(moved == vec);
+    vector_t other;
+    swap(other, moved);
+    REQUIRE(other == vec);
+    get<k::i>(other, 17) = 42;
+    REQUIRE(other != vec);
+  }
+  SECTION("algorithms") {
+    std::reverse(vec.begin(), vec.end());
+    std::reverse(ref.begin(), ref.end());
+    check_equal(vec, ref);
+  }
+}
@@ -0,0 +1,120 @@
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <vector>
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+#include "test_types.hpp"
+#include "scattered/vector.hpp"
+#include "scattered/tiled_vector.hpp"
+#include "scattered/transform.hpp"
+
+/// \test scattered::transform and scattered::reduce tests
+template <class Vector> void test_transform(Vector vec) {
+  using k = TestType::k;
+  using scattered::get;
+
+  const int n = 1003;  // not a multiple of the vector width
+  std::vector<TestType> ref;
+  for (int i = 0; i != n; ++i) {
+    const TestType t{static_cast<float>(i % 13) / 4.f, 0.5 * i, i - 500,
+                     i % 3 == 0};
+    ref.push_back(t);
+    vec.push_back(t);
+  }
+  auto check = [&]() {
+    REQUIRE(vec.size() == ref.size());
+    for (std::size_t i = 0; i != ref.size(); ++i) {
+      REQUIRE(get<k::x>(vec, i) == Approx(ref[i].x));
+      REQUIRE(get<k::y>(vec, i) == Approx(ref[i].y));
+      REQUIRE(get<k::i>(vec, i) == ref[i].i);
+      REQUIRE(get<k::b>(vec, i) == ref[i].b);
+    }
+  };
+
+  SECTION("transform in place") {
+    scattered::transform<k::y>(vec, [](auto y) { return y * y; }, k::y{});
+    for (auto& t : ref) { t.y *= t.y; }
+    check();
+    scattered::transform<k::b>(vec, [](bool b) { return !b; }, k::b{});
+    for (auto& t : ref) { t.b = !t.b; }
+    check();
+  }
+  SECTION("transform with widening and narrowing") {
+    // double = f(float, int)
+    scattered::transform<k::y>(vec, [](float x, int i) { return x * i; },
+                               k::x{}, k::i{});
+    for (auto& t : ref) { t.y = t.x * t.i; }
+    check();
+    // float = f(double, float)
+    scattered::transform<k::x>(vec, [](double y, float x) { return y + x; },
+                               k::y{}, k::x{});
+    for (auto& t : ref) { t.x = static_cast<float>(t.y + t.x); }
+    check();
+    // int = f(double), bool = f(int)
+    scattered::transform<k::i>(vec, [](double y) { return y / 3.; }, k::y{});
+    for (auto& t : ref) { t.i = static_cast<int>(t.y / 3.); }
+    scattered::transform<k::b>(vec, [](int i) { return i % 2; }, k::i{});
+    for (auto& t : ref) { t.b = static_cast<bool>(t.i % 2); }
+    check();
+  }
+  SECTION("transform without inputs") {
+    scattered::transform<k::i>(vec, []() { return 7; });
+    for (auto& t : ref) { t.i = 7; }
+    check();
+  }
+  SECTION("reduce") {
+    const auto& cvec = vec;
+    double sum_x = 0.;
+    long sum_i = 0;
+    int max_i = std::numeric_limits<int>::min();
+    std::size_t no_b = 0;
+    for (auto& t : ref) {
+      sum_x += t.x;
+      sum_i += t.i;
+      max_i = std::max(max_i, t.i);
+      no_b += t.b;
+    }
+    REQUIRE(scattered::reduce<k::x>(cvec, 0., std::plus<>{}) == Approx(sum_x));
+    REQUIRE(scattered::reduce<k::i>(cvec, 0l, std::plus<>{}) == sum_i);
+    REQUIRE(scattered::reduce<k::i>(cvec, std::numeric_limits<int>::min(),
+                                    [](int a, int b) { return std::max(a, b); })
+            == max_i);
+    REQUIRE(scattered::reduce<k::b>(cvec, std::size_t(0), std::plus<>{})
+            == no_b);
+    // Less rows than partial results:
+    vec.resize(5);
+    REQUIRE(scattered::reduce<k::i>(cvec, 1l, std::plus<>{})
+            == 1 + (-500 - 499 - 498 - 497 - 496));
+    vec.clear();
+    REQUIRE(scattered::reduce<k::y>(cvec, 2., std::plus<>{}) == 2.);
+  }
+}
+
+TEST_CASE("Test scattered::transform", "[scattered][transform]") {
+  test_transform(scattered::vector<TestType>{});
+}
+
+TEST_CASE("Test scattered::transform with arena_storage",
+          "[scattered][transform]") {
+  test_transform(scattered::vector<TestType, scattered::arena_storage<>>{});
+}
+
+TEST_CASE("Test scattered::transform with tiled storage",
+          "[scattered][transform]") {
+  test_transform(scattered::tiled_vector<TestType, 64>{});
+}
+
+TEST_CASE("Test scattered::transform column pointers",
+          "[scattered][transform]") {
+  using k = TestType::k;
+  using storage = scattered::vector<TestType>::storage_type;
+  using tiled_storage = scattered::tiled_vector<TestType, 64>::storage_type;
+  static_assert(scattered::detail::contiguous_columns<storage, k::x, k::y>(),
+                "");
+  static_assert(!scattered::detail::contiguous_columns<storage, k::x, k::b>(),
+                "packed bool columns are not contiguous");
+  static_assert(!scattered::detail::contiguous_columns<tiled_storage, k::x>(),
+                "");
+}
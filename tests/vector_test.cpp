@@ -1,5 +1,6 @@
 #include <iostream>
 #include <algorithm>
+#include <cstdint>
 #include <vector>
 #include <boost/range/algorithm.hpp>
 #include <boost/range/algorithm_ext/push_back.hpp>
@@ -44,6 +45,19 @@ template <class T> void print_container(const std::string, T&&) {}
 template <class T>
 using container_t = scattered::vector<TestType>::container_type<T>;
 
+/// Type whose first column is a packed bool column
+struct BoolFirstType {
+  bool b;
+  int i;
+  struct k {
+    struct b {};
+    struct i {};
+  };
+};
+
+BOOST_FUSION_ADAPT_ASSOC_STRUCT(BoolFirstType, (bool, b, BoolFirstType::k::b)(
+                                                   int, i, BoolFirstType::k::i))
+
 /// \test scattered::vector tests
 TEST_CASE("Test scattered::vector<T>", "[scattered][vector]") {
   using k = TestType::k;  // Lets import the keys, we'll need them often.
@@ -112,14 +126,14 @@ TEST_CASE("Test scattered::vector<T>", "[scattered][vector]") {
         std::is_same
         <scattered::detail::unqualified_t<decltype(get<k::x>(vec.begin()))>,
          scattered::detail::unqualified_t
-         <decltype(get<k::x>(vec.begin().it()))>>::value,
+         <decltype(vec.data<k::x>().begin())>>::value,
         "get return value mismatch");
 
     static_assert(
         std::is_same
         <scattered::detail::unqualified_t<decltype(get<k::x>(vec.cbegin()))>,
          scattered::detail::unqualified_t
-         <decltype(get<k::x>(vec.cbegin().it()))>>::value,
+         <decltype(vec.data<k::x>().cbegin())>>::value,
         "get return value mismatch");
 
     decltype(auto) it_x = get<k::x>(it);
@@ -219,7 +233,7 @@ TEST_CASE("Test scattered::vector<T>", "[scattered][vector]") {
     REQUIRE((get<k::x>(re) - get<k::x>(rb)) == ref_size);
     REQUIRE((get<k::x>(rce) - get<k::x>(rcb)) == ref_size);
 
-    REQUIRE((get<k::x>(vec.end().it()) - get<k::x>(vec.begin().it()))
+    REQUIRE((vec.data<k::x>().end() - vec.data<k::x>().begin())
             == ref_size);
     REQUIRE((get<k::y>(vec.end()) - get<k::y>(vec.begin())) == ref_size);
     REQUIRE((get<k::x>(vec.cend()) - get<k::x>(vec.cbegin())) == ref_size);
@@ -283,13 +297,45 @@ TEST_CASE("Test scattered::vector<T>", "[scattered][vector]") {
     print_container("empty vec:", new_vec);
   }
   SECTION("Member function: at") {
-    /// \todo
+    const auto& cvec = vec;
+    for (std::size_t i = 0; i != ref.size(); ++i) {
+      REQUIRE(get<k::x>(vec.at(i)) == Approx(ref.at(i).x));
+      REQUIRE(get<k::i>(cvec.at(i)) == ref.at(i).i);
+    }
+    REQUIRE_THROWS_AS(vec.at(ref.size()), std::out_of_range);
+    REQUIRE_THROWS_AS(cvec.at(ref.size()), std::out_of_range);
   }
   SECTION("Member function: operator[]") {
-    /// \todo
+    const auto& cvec = vec;
+    for (std::size_t i = 0; i != ref.size(); ++i) {
+      REQUIRE(get<k::y>(vec[i]) == Approx(ref[i].y));
+      REQUIRE(get<k::b>(cvec[i]) == ref[i].b);
+      REQUIRE(get<k::i>(vec[i]) == get<k::i>(vec.begin()[i]));
+    }
+    vec[3] = ref[5];
+    REQUIRE(get<k::i>(vec[3]) == ref[5].i);
+    static_assert(std::is_same<decltype(vec[0]),
+                               scattered::vector<TestType>::reference>::value,
+                  "operator[] returns a reference proxy");
+  }
+  SECTION("Free function: get<K>(vector, i)") {
+    const auto& cvec = vec;
+    for (std::size_t i = 0; i != ref.size(); ++i) {
+      REQUIRE(get<k::x>(vec, i) == Approx(ref[i].x));
+      REQUIRE(get<k::i>(cvec, i) == ref[i].i);
+    }
+    get<k::i>(vec, 2) = 42;
+    REQUIRE(get<k::i>(vec[2]) == 42);
+    static_assert(std::is_same<decltype(get<k::i>(vec, 0)),
+                               container_t<int>::reference>::value,
+                  "get<K>(vector, i) returns a column reference");
   }
   SECTION("Member function: front/back") {
-    /// \todo
+    const auto& cvec = vec;
+    REQUIRE(get<k::i>(vec.front()) == ref.front().i);
+    REQUIRE(get<k::i>(vec.back()) == ref.back().i);
+    REQUIRE(get<k::x>(cvec.front()) == Approx(ref.front().x));
+    REQUIRE(get<k::x>(cvec.back()) == Approx(ref.back().x));
   }
   SECTION("Member function: capacity/empty/reserve/shrink_to_fit") {
     /// \todo
@@ -450,3 +496,254 @@ TEST_CASE("Test scattered::vector<T>", "[scattered][vector]") {
   //   print_container("After push_back | reversed", vec);
   // }
 }
+
+/// \test The capacity of a vector is the smallest capacity of its columns
+TEST_CASE("Test scattered::vector<T>::capacity with packed bool columns",
+          "[scattered][vector]") {
+  using k = BoolFirstType::k;
+  scattered::vector<BoolFirstType> vec;
+  vec.reserve(5);
+  REQUIRE(vec.data<k::b>().capacity() >= 64);
+  REQUIRE(vec.capacity() == vec.data<k::i>().capacity());
+  REQUIRE(vec.capacity() >= 5);
+  REQUIRE(vec.capacity() < 64);
+}
+
+/// \test scattered::vector with all columns in a single allocation
+TEST_CASE("Test scattered::vector<T, arena_storage<>>",
+          "[scattered][vector][arena]") {
+  using k = TestType::k;
+  using vector_t = scattered::vector<TestType, scattered::arena_storage<>>;
+
+  vector_t vec;
+  std::vector<TestType> ref;
+  for (int i = 0; i != 100; ++i) {
+    vec.push_back(make_row(i));
+    ref.push_back(make_row(i));
+  }
+
+  SECTION("push_back grows all columns at once") {
+    check_equal(vec, ref);
+    REQUIRE(vec.capacity() >= vec.size());
+    REQUIRE(vec.data<k::x>().size() == vec.size());
+    REQUIRE(vec.data<k::b>().size() == vec.size());
+  }
+  SECTION("columns are stored contiguously in a single buffer") {
+    vec.shrink_to_fit();
+    REQUIRE(vec.capacity() == vec.size());
+    auto const& s = vec.storage();
+    REQUIRE(s.offset<k::x>() == 0);
+    REQUIRE(s.offset<k::y>() >= vec.size() * sizeof(float));
+    REQUIRE(s.offset<k::i>() == s.offset<k::y>() + vec.size() * sizeof(double));
+    REQUIRE(s.offset<k::b>() == s.offset<k::i>() + vec.size() * sizeof(int));
+    auto x = reinterpret_cast<const char*>(vec.data<k::x>().data());
+    auto b = reinterpret_cast<const char*>(vec.data<k::b>().data());
+    REQUIRE(b - x == static_cast<std::ptrdiff_t>(s.offset<k::b>()));
+  }
+  SECTION("reserve/resize/clear") {
+    vec.reserve(1000);
+    REQUIRE(vec.capacity() == 1000);
+    check_equal(vec, ref);
+    vec.resize(200);
+    ref.resize(200);
+    check_equal(vec, ref);
+    vec.resize(50);
+    ref.resize(50);
+    check_equal(vec, ref);
+    vec.clear();
+    REQUIRE(vec.empty());
+    REQUIRE(vec.capacity() == 1000);
+  }
+  SECTION("insert/erase") {
+    TestType t = {-1.0, -2.0, -3, true};
+    vec.insert(vec.cbegin() + 10, t);
+    ref.insert(ref.cbegin() + 10, t);
+    check_equal(vec, ref);
+    vec.erase(vec.cbegin() + 5);
+    ref.erase(ref.cbegin() + 5);
+    check_equal(vec, ref);
+    vec.erase(vec.cbegin() + 20, vec.cbegin() + 40);
+    ref.erase(ref.cbegin() + 20, ref.cbegin() + 40);
+    check_equal(vec, ref);
+    vec.pop_back();
+    ref.pop_back();
+    check_equal(vec, ref);
+  }
+  SECTION("copy/move/swap") {
+    vector_t copy(vec);
+    REQUIRE(copy == vec);
+    vector_t moved(std::move(copy));
+    REQUIRE(moved == vec);
+    REQUIRE(copy.empty());
+    vector_t other;
+    swap(other, moved);
+    REQUIRE(other == vec);
+    REQUIRE(moved.empty());
+    other.data<k::i>()[0] = 42;
+    REQUIRE(other != vec);
+  }
+}
+
+/// \test scattered::vector with aligned and padded columns
+TEST_CASE("Test scattered::vector<T, aligned_container_storage<64, 8>>",
+          "[scattered][vector][aligned]") {
+  using k = TestType::k;
+  using scattered::get;
+  using policy = scattered::aligned_container_storage<64, 8>;
+  using vector_t = scattered::vector<TestType, policy>;
+
+  static_assert(vector_t::storage_type::alignment == 64, "wrong alignment");
+  static_assert(vector_t::storage_type::width == 8, "wrong width");
+
+  auto is_aligned = [](const void* p) {
+    return reinterpret_cast<std::uintptr_t>(p) % 64 == 0;
+  };
+
+  vector_t vec;
+  for (int i = 0; i != 13; ++i) {
+    vec.push_back({static_cast<float>(i), static_cast<double>(i), i, false});
+    REQUIRE(is_aligned(vec.data<k::x>().data()));
+    REQUIRE(is_aligned(vec.data<k::y>().data()));
+    REQUIRE(is_aligned(vec.data<k::i>().data()));
+  }
+  SECTION("the padding up to a multiple of width can be written") {
+    // The last row is processed with a full width-sized chunk:
+    const std::size_t padded = (vec.size() + 7) / 8 * 8;
+    auto x = vec.data<k::x>().data();
+    for (std::size_t i = 0; i != padded; ++i) { x[i] *= 2.f; }
+    for (std::size_t i = 0; i != vec.size(); ++i) {
+      REQUIRE(get<k::x>(vec, i) == Approx(2.f * i));
+    }
+  }
+  SECTION("copies keep the alignment") {
+    vector_t copy(vec);
+    REQUIRE(copy == vec);
+    REQUIRE(is_aligned(copy.data<k::y>().data()));
+    copy.shrink_to_fit();
+    REQUIRE(is_aligned(copy.data<k::y>().data()));
+  }
+}
+
+/// \test scattered::vector with interleaved groups of columns
+TEST_CASE("Test scattered::vector<T, grouped<group<Ks...>>>",
+          "[scattered][vector][grouped]") {
+  using k = TestType::k;
+  using scattered::get;
+  using scattered::group;
+  using hot = group<k::x, k::i>;
+  using container_t = scattered::vector<TestType, scattered::grouped<hot>>;
+  using arena_t = scattered::vector
+      <TestType, scattered::grouped_storage<scattered::arena_storage<>, hot>>;
+
+  static_assert(std::is_same<container_t::storage_type::inner_columns,
+                             scattered::detail::column_list
+                             <scattered::detail::column
+                              <hot, std::tuple<float, int>>,
+                              scattered::detail::column<k::y, double>,
+                              scattered::detail::column<k::b, bool>>>::value,
+                "the group must replace the columns of its keys");
+
+  auto test = [](auto vec) {
+    using vector_t = decltype(vec);
+    std::vector<TestType> ref;
+    for (int i = 0; i != 37; ++i) {
+      vec.push_back(make_row(i));
+      ref.push_back(make_row(i));
+    }
+
+    check_equal(vec, ref);
+
+    // The members of the group are interleaved:
+    auto x0 = reinterpret_cast<const char*>(&get<k::x>(vec, 0));
+    auto x1 = reinterpret_cast<const char*>(&get<k::x>(vec, 1));
+    auto i0 = reinterpret_cast<const char*>(&get<k::i>(vec, 0));
+    REQUIRE(x1 - x0 == static_cast<std::ptrdiff_t>(sizeof(std::tuple<float,
+                                                                     int>)));
+    REQUIRE(std::abs(i0 - x0) < static_cast<std::ptrdiff_t>(x1 - x0));
+
+    // Column iterators and ranges of grouped keys:
+    REQUIRE(std::distance(get<k::i>(vec.begin()), get<k::i>(vec.end())) == 37);
+    REQUIRE(std::count(get<k::b>(vec.cbegin()), get<k::b>(vec.cend()), true)
+            == 13);
+    for (auto& x : vec.template data<k::x>()) { x *= 2.f; }
+    for (auto& r : ref) { r.x *= 2.f; }
+    check_equal(vec, ref);
+    REQUIRE(vec.template data<k::i>().size() == 37);
+
+    TestType t = {-1.0, -2.0, -3, true};
+    vec.insert(vec.cbegin() + 10, t);
+    ref.insert(ref.cbegin() + 10, t);
+    vec.erase(vec.cbegin() + 2, vec.cbegin() + 12);
+    ref.erase(ref.cbegin() + 2, ref.cbegin() + 12);
+    check_equal(vec, ref);
+
+    vec.resize(50);
+    ref.resize(50);
+    check_equal(vec, ref);
+
+    std::reverse(vec.begin(), vec.end());
+    std::reverse(ref.begin(), ref.end());
+    check_equal(vec, ref);
+
+    vector_t copy(vec);
+    REQUIRE(copy == vec);
+    vector_t other;
+    swap(other, copy);
+    REQUIRE(other == vec);
+    REQUIRE(copy.empty());
+    get<k::i>(other, 3) = 42;
+    REQUIRE(other != vec);
+  };
+  test(container_t{});
+  test(arena_t{});
+}
+
+/// \test scattered::vector with columns backed by huge pages
+TEST_CASE("Test scattered::vector<T, huge_page_storage<Pages, Prefault>>",
+          "[scattered][vector][huge_pages]") {
+  using k = TestType::k;
+  using scattered::get;
+  using scattered::huge_pages;
+
+  // 2^20 rows: the float, double and int columns span whole huge pages
+  const std::size_t n = std::size_t(1) << 20;
+  auto test = [&](auto vec) {
+    vec.resize(n);
+    for (std::size_t i = 0; i < n; i += 4099) {
+      get<k::x>(vec, i) = static_cast<float>(i);
+      get<k::i>(vec, i) = static_cast<int>(i);
+      get<k::b>(vec, i) = true;
+    }
+    for (std::size_t i = 0; i < n; i += 4099) {
+      REQUIRE(get<k::x>(vec, i) == Approx(static_cast<float>(i)));
+      REQUIRE(get<k::i>(vec, i) == static_cast<int>(i));
+      REQUIRE(get<k::b>(vec, i));
+    }
+    auto copy = vec;
+    REQUIRE(copy == vec);
+    vec.push_back({1.f, 2., 3, false});
+    REQUIRE(vec.size() == n + 1);
+    vec.clear();
+    vec.shrink_to_fit();
+    REQUIRE(vec.empty());
+  };
+
+  SECTION("transparent huge pages are aligned to the huge page size") {
+    using vector_t
+        = scattered::vector<TestType, scattered::huge_page_storage<>>;
+    vector_t vec(n);
+    auto x = reinterpret_cast<std::uintptr_t>(&get<k::x>(vec, 0));
+    REQUIRE(x % (std::size_t(2) << 20) == 0);
+    test(vector_t{});
+  }
+  SECTION("prefaulted explicit huge pages (or the madvise fallback)") {
+    test(scattered::vector
+         <TestType,
+          scattered::huge_page_storage<huge_pages::hugetlb, true>>{});
+  }
+  SECTION("arena") {
+    test(scattered::vector
+         <TestType, scattered::arena_storage
+                    <scattered::huge_page_allocator<char>>>{});
+  }
+}
@@ -0,0 +1,69 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <vector>
+#include <boost/range/algorithm.hpp>
+#include <boost/range/numeric.hpp>
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+#include "test_types.hpp"
+#include "scattered/vector.hpp"
+#include "scattered/view.hpp"
+
+/// \test scattered::view tests
+TEST_CASE("Test scattered::view<Ks...>", "[scattered][view]") {
+  using k = TestType::k;
+  using scattered::get;
+
+  const int n = 100;
+  scattered::vector<TestType> vec;
+  for (int i = 0; i != n; ++i) {
+    vec.push_back({static_cast<float>(n - i), static_cast<double>(i), i,
+                   i % 2 == 0});
+  }
+
+  SECTION("sorting a view only moves its columns") {
+    boost::sort(scattered::view<k::x, k::b>(vec), [](auto a, auto b) {
+      return get<k::x>(a) < get<k::x>(b);
+    });
+    for (int i = 0; i != n; ++i) {
+      REQUIRE(get<k::x>(vec, i) == Approx(static_cast<float>(i + 1)));
+      REQUIRE(get<k::b>(vec, i) == ((n - 1 - i) % 2 == 0));
+      // The other columns are not touched:
+      REQUIRE(get<k::y>(vec, i) == Approx(static_cast<double>(i)));
+      REQUIRE(get<k::i>(vec, i) == i);
+    }
+    std::stable_sort(scattered::view<k::x>(vec).begin(),
+                     scattered::view<k::x>(vec).end(),
+                     [](auto a, auto b) { return get<k::x>(b) < get<k::x>(a); });
+    REQUIRE(get<k::x>(vec, 0) == Approx(static_cast<float>(n)));
+    REQUIRE(get<k::i>(vec, 0) == 0);
+  }
+  SECTION("scans and in-place transforms") {
+    auto v = scattered::view<k::i, k::y>(vec);
+    REQUIRE(v.size() == static_cast<std::size_t>(n));
+    for (auto&& r : v) { get<k::y>(r) *= 2; }
+    REQUIRE(get<k::y>(vec, 3) == Approx(6.));
+    const auto sum = boost::accumulate(v, 0, [](int s, auto r) {
+      return s + get<k::i>(r);
+    });
+    REQUIRE(sum == n * (n - 1) / 2);
+    std::reverse(v.begin(), v.end());
+    REQUIRE(get<k::i>(vec, 0) == n - 1);
+    REQUIRE(get<k::x>(vec, 0) == Approx(static_cast<float>(n)));
+    // Copying a row into a value only copies the viewed columns:
+    TestType t = v[0];
+    REQUIRE(t.i == n - 1);
+    REQUIRE(t.x == 0.f);
+  }
+  SECTION("views of const vectors") {
+    const auto& cvec = vec;
+    auto v = scattered::view<k::b>(cvec);
+    REQUIRE(boost::count_if(v, [](auto r) { return get<k::b>(r); }) == n / 2);
+    REQUIRE(get<k::b>(v[0]));
+    REQUIRE(v[1] != v[0]);
+    REQUIRE(v[2] == v[0]);
+  }
+}